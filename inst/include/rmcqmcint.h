@@ -0,0 +1,123 @@
+#pragma once
+#ifndef RMCQMCINT_H
+#define RMCQMCINT_H
+/**
+ * @file rmcqmcint.h
+ *
+ * @brief interface of compiled integrands for qmcint() and mcint().
+ *
+ * A compiled integrand is passed to qmcint() and mcint() as an external
+ * pointer to NativeIntegrand, and is called by the integration driver
+ * directly, without R function call.
+ *
+ * Example, in a package with LinkingTo: rmcqmcint, or by
+ * Rcpp::sourceCpp with // [[Rcpp::depends(rmcqmcint)]]
+ * \code
+ * #include <Rcpp.h>
+ * #include <rmcqmcint.h>
+ *
+ * static double sum(const double x[], int s, void * data) {
+ *     double r = 0;
+ *     for (int i = 0; i < s; i++) {
+ *         r += x[i];
+ *     }
+ *     return r;
+ * }
+ *
+ * // [[Rcpp::export]]
+ * SEXP sumIntegrand() {
+ *     rmcqmcint::NativeIntegrand * f = new rmcqmcint::NativeIntegrand();
+ *     f->scalar = sum;
+ *     return rmcqmcint::wrapNativeIntegrand(f);
+ * }
+ * \endcode
+ * then qmcint(sumIntegrand(), 100, 4) in R.
+ * External pointers without the tag of wrapNativeIntegrand() are
+ * rejected.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <Rcpp.h>
+#include <cstddef>
+
+namespace rmcqmcint {
+
+    /**
+     * integrand of a point
+     * @param x a point, s doubles.
+     * @param s dimension.
+     * @param data user data of NativeIntegrand.
+     * @return value of integrand at \b x.
+     */
+    typedef double (*integrand_scalar_t)(const double x[], int s,
+                                         void * data);
+
+    /**
+     * integrand of a block of points
+     * @param x n points, i-th point is x[i * s], ..., x[i * s + s - 1].
+     * @param n number of points.
+     * @param s dimension.
+     * @param out n * outputs values of integrand, k-th output at i-th
+     * point is out[i * outputs + k].
+     * @param data user data of NativeIntegrand.
+     */
+    typedef void (*integrand_block_t)(const double x[], int n, int s,
+                                      double out[], void * data);
+
+    /**
+     * parametric integrand of a block of points, for qmcsweep()
+     * @param x n points, the same as integrand_block_t.
+     * @param n number of points.
+     * @param s dimension.
+     * @param theta parameters, q doubles.
+     * @param q number of parameters.
+     * @param out n values of integrand with parameters \b theta.
+     * @param data user data of NativeIntegrand.
+     */
+    typedef void (*integrand_parametric_t)(const double x[], int n, int s,
+                                           const double theta[], int q,
+                                           double out[], void * data);
+
+    /**
+     * Compiled integrand.
+     * At least one of \b scalar and \b block should not be NULL.
+     * \b block is used if it is not NULL.
+     * Vector valued integrand has \b outputs > 1 and \b block.
+     * qmcsweep() uses \b parametric only.
+     */
+    struct NativeIntegrand {
+        NativeIntegrand() : scalar(NULL), block(NULL), data(NULL),
+                            outputs(1), parametric(NULL) {}
+        integrand_scalar_t scalar;
+        integrand_block_t block;
+        void * data;
+        int outputs;
+        integrand_parametric_t parametric;
+    };
+
+    /**
+     * tag of external pointer to NativeIntegrand
+     */
+    const char * const native_integrand_tag = "rmcqmcint::NativeIntegrand";
+
+    /**
+     * Makes external pointer to \b f, which is deleted by R, tagged
+     * as NativeIntegrand.
+     * @param f compiled integrand allocated by new.
+     * @return external pointer passed to qmcint() and mcint().
+     */
+    inline SEXP wrapNativeIntegrand(NativeIntegrand * f) {
+        return Rcpp::XPtr<NativeIntegrand>(f, true,
+                                           Rf_install(native_integrand_tag));
+    }
+}
+#endif // RMCQMCINT_H
@@ -21,6 +21,7 @@
  */
 #include "grayindex.h"
 #include "MersenneTwister64.h"
+#include "simd_kernel.h"
 #include <stdint.h>
 #include <cstring>
 #include <fstream>
@@ -29,6 +30,7 @@
 #include <string>
 #include <cerrno>
 #include <cmath>
+#include <algorithm>
 #if defined(IN_RCPP)
 #include <Rcpp.h>
 #endif
@@ -45,6 +47,42 @@ namespace DigitalNetNS {
         RANDOM = -1
     };
 
+    /**
+     * memory layout of point buffers filled by DigitalNet::fillPoints.
+     *
+     * POINT_MAJOR: j-th coordinate of i-th point is out[i * ld + j].
+     * COORDINATE_MAJOR: j-th coordinate of i-th point is out[j * ld + i],
+     * which is the layout of R's column major matrix.
+     */
+    enum point_layout {
+        POINT_MAJOR = 0,
+        COORDINATE_MAJOR = 1
+    };
+
+    /**
+     * order of points generated by DigitalNet::fillRange.
+     *
+     * GRAY_ORDER: the order of nextPoint(), i-th point is the sum of
+     * base rows selected by the gray code of i.
+     * NATURAL_ORDER: i-th point is the sum of base rows selected by
+     * the binary representation of i.
+     */
+    enum point_order {
+        GRAY_ORDER = 0,
+        NATURAL_ORDER = 1
+    };
+
+    /*
+     * ranges of at least this number of points are generated by
+     * bit sliced 64 points engine.
+     */
+    const size_t bit_sliced_threshold = 256;
+
+    /*
+     * default number of coordinates generated together by fillRange().
+     */
+    const uint32_t default_tile = 128;
+
     uint32_t getParameterSize();
     const std::string getDigitalNetName(uint32_t index);
     const std::string getDigitalNetConstruction(uint32_t index);
@@ -79,6 +117,56 @@ namespace DigitalNetNS {
     int getMMax(digital_net_id id, int s);
     int getMMin(digital_net_id id, int s);
 #endif // IN_RCPP
+
+    /**
+     * Random linear scramble of a coordinate.
+     *
+     * Multiplies \b size elements x[k * stride] by a random nonsingular
+     * lower triangular matrix L over F2, whose rows are drawn from \b mt.
+     * Each element is regarded as a column vector, MSB first.
+     *
+     * L x is computed as XOR of columns of L selected by bits of x,
+     * looking up a table of all combinations of four columns
+     * (method of four Russians), so that the cost is N / 4 lookups
+     * for each element after building the table.
+     * @param x elements to be scrambled.
+     * @param size number of elements.
+     * @param stride distance between elements.
+     * @param mt random number generator.
+     */
+    template<typename U>
+    void linearScramble(U x[], uint32_t size, size_t stride,
+                        MersenneTwister64& mt)
+    {
+        const int N = sizeof(U) * 8;
+        const U one = 1;
+        U col[N];
+        U table[N / 4][16];
+        // rows of L, the same random numbers as the former innerProduct
+        // implementation, col[b] is the row of bit b here.
+        for (int j = 0; j < N; j++) {
+            U p2 = one << (N - j - 1);
+            col[N - j - 1] = (static_cast<U>(mt()) << (N - j - 1)) | p2;
+        }
+        // col[b] is L times bit b
+        transpose(col);
+        for (int g = 0; g < N / 4; g++) {
+            table[g][0] = 0;
+            for (int v = 1; v < 16; v++) {
+                table[g][v] = table[g][v & (v - 1)]
+                    ^ col[4 * g + tailingZeroBit(static_cast<uint32_t>(v))];
+            }
+        }
+        for (uint32_t k = 0; k < size; k++) {
+            U v = x[k * stride];
+            U y = 0;
+            for (int g = 0; g < N / 4; g++) {
+                y ^= table[g][(v >> (4 * g)) & 15];
+            }
+            x[k * stride] = y;
+        }
+    }
+
     template<typename U>
     class DigitalNet {
     private:
@@ -122,8 +210,11 @@ namespace DigitalNetNS {
             point_base = NULL;
             point = NULL;
             count = 0;
+            tile = default_tile;
             digitalShift = false;
             shiftVector = false;
+            owenScrambling = false;
+            owen_seed = NULL;
         }
 #endif
 #if defined(IN_RCPP)
@@ -144,8 +235,11 @@ namespace DigitalNetNS {
             point_base = NULL;
             point = NULL;
             count = 0;
+            tile = default_tile;
             digitalShift = false;
             shiftVector = false;
+            owenScrambling = false;
+            owen_seed = NULL;
         }
 #else
         DigitalNet(const digital_net_id& id, uint32_t s, uint32_t m) {
@@ -164,8 +258,11 @@ namespace DigitalNetNS {
             point_base = NULL;
             point = NULL;
             count = 0;
+            tile = default_tile;
             digitalShift = false;
             shiftVector = false;
+            owenScrambling = false;
+            owen_seed = NULL;
         }
 #endif // IN_RCPP
 
@@ -182,6 +279,9 @@ namespace DigitalNetNS {
             if (point != NULL) {
                 delete[] point;
             }
+            if (owen_seed != NULL) {
+                delete[] owen_seed;
+            }
         }
 
         U getBase(int i, int j) const {
@@ -219,6 +319,18 @@ namespace DigitalNetNS {
             }
         }
 
+        /**
+         * Turns on or off Owen scrambling, hash based nested uniform
+         * scrambling. When on, pointInitialize() draws a random seed for
+         * each coordinate, and points are scrambled in integer before
+         * conversion to double. Digital shift, if any, is applied before
+         * scrambling.
+         * @param value true for on.
+         */
+        void setOwenScramble(bool value) {
+            owenScrambling = value;
+        }
+
         const double * getPoint() const {
             return point;
         }
@@ -227,6 +339,50 @@ namespace DigitalNetNS {
             return point_base;
         }
 
+        /**
+         * Computes point_base of the point of \b index in gray code
+         * order, without moving the cursor.
+         * O(m s) XOR operations.
+         * @param index index of the point, 0 <= index < 2^m
+         * @param out s elements of point_base without digital shift
+         */
+        void getPointBase(uint64_t index, U out[]) const {
+            for (uint32_t i = 0; i < s; i++) {
+                out[i] = 0;
+            }
+            addRows(index ^ (index >> 1), out);
+        }
+
+        /**
+         * Index of the current point in gray code order.
+         * @return index of the current point
+         */
+        uint64_t getPointIndex() const {
+            return count - 1;
+        }
+
+        /**
+         * Moves the cursor to the point of \b index in gray code order,
+         * in O(m s) operations.
+         * After this, getPoint() returns the point of \b index and
+         * nextPoint() moves to the point of index + 1.
+         * If pointInitialize() has not been called, it is called first.
+         * @param index index of the point, 0 <= index < 2^m
+         * @exception when index is out of range.
+         */
+        void jumpTo(uint64_t index) {
+            if (index >= (UINT64_C(1) << m)) {
+                throw "index out of range!";
+            }
+            if (point_base == NULL) {
+                pointInitialize();
+            }
+            getPointBase(index, point_base);
+            count = index + 1;
+            gray.set(count);
+            convertPoint();
+        }
+
         uint32_t getS() const {
             return s;
         }
@@ -241,31 +397,21 @@ namespace DigitalNetNS {
             }
         }
 
-#if defined(USE_SCRAMBLE)
-        // Random Linear Scramble
-        // Base を変えてしまう => いいのかも。
+        /**
+         * Random linear scramble (Matousek).
+         * Multiplies each coordinate of base by a random nonsingular
+         * lower triangular matrix, see linearScramble().
+         * Base is changed, saveBase() and restoreBase() to get the
+         * original base back. pointInitialize() should be called after
+         * this.
+         */
         void scramble() {
-            const size_t N = sizeof(U) * 8;
-            U LowTriMat[N];
-            U tmp;
-            const U one = 1;
-            for (size_t i = 0; i < s; i++) {
-                // 正則な下三角行列を作る
-                for (size_t j = 0; j < N; j++) {
-                    U p2 = one << (N - j - 1);
-                    LowTriMat[j] = (mt() << (N - j - 1)) | p2;
-                }
-                for (size_t k = 0; k < m; k++) {
-                    tmp = UINT64_C(0);
-                    for (size_t j = 0; j < N; j++) {
-                        U bit = innerProduct(LowTriMat[j], getBase(k, i));
-                        tmp ^= bit << (N - j - 1);
-                    }
-                    setBase(k, i, tmp);
-                }
+            for (uint32_t i = 0; i < s; i++) {
+                linearScramble(base + i, m, s, mt);
             }
         }
 
+#if defined(USE_SCRAMBLE)
         /** Hill Climb Linear Scramble.
          *
          *
@@ -302,15 +448,6 @@ namespace DigitalNetNS {
             using namespace std;
             cout << "in pointInitialize" << endl;
 #endif
-            if (sizeof(U) * 8 == 64) {
-                get_max = 64 - 53;
-                factor = exp2(-53);
-                eps = exp2(-64);
-            } else {
-                get_max = 0;
-                factor = exp2(-32);
-                eps = exp2(-33);
-            }
             if (shift == NULL) {
                 shift = new U[s]();
             }
@@ -320,20 +457,25 @@ namespace DigitalNetNS {
             if (point == NULL) {
                 point = new double[s]();
             }
+            if (owen_seed == NULL) {
+                owen_seed = new U[s]();
+            }
             for (uint32_t i = 0; i < s; ++i) {
                 point_base[i] = 0;
             }
             if (!shiftVector) {
                 if (digitalShift) {
-                    for (uint32_t i = 0; i < s; ++i) {
-                        shift[i] = mt();
-                    }
+                    drawDigitalShift(shift);
                 } else {
                     for (uint32_t i = 0; i < s; ++i) {
                         shift[i] = 0;
                     }
                 }
             }
+            if (owenScrambling) {
+                // seeds are random words as well as shifts
+                drawDigitalShift(owen_seed);
+            }
             gray.clear();
             count = 0;
             count++;
@@ -348,12 +490,238 @@ namespace DigitalNetNS {
             using namespace std;
             cout << "in nextPoint" << endl;
 #endif
+            stepPoint();
+            convertPoint();
+#if defined(DEBUG)
+            cout << "out nextPoint" << endl;
+#endif
+        }
+
+        /**
+         * Block version of getPoint() and nextPoint().
+         *
+         * Writes \b count consecutive points, starting from the current
+         * point, into caller's buffer. After the call, the digital net is
+         * in the same state as after calling nextPoint() \b count times.
+         *
+         * When \b threads > 1 and the points do not wrap around 2^m,
+         * the points are split into contiguous ranges, each of them is
+         * generated by fillRange() in its own thread.
+         * @param out buffer, at least (count - 1) * ld + s doubles for
+         * POINT_MAJOR and (s - 1) * ld + count doubles for COORDINATE_MAJOR.
+         * @param count number of points to be written.
+         * @param layout memory layout of \b out.
+         * @param ld leading dimension of \b out, 0 means s for POINT_MAJOR
+         * and count for COORDINATE_MAJOR.
+         * @param threads number of threads.
+         */
+        void fillPoints(double out[], size_t count,
+                        point_layout layout = POINT_MAJOR, size_t ld = 0,
+                        int threads = 1) {
+            if (ld == 0) {
+                ld = (layout == POINT_MAJOR) ? s : count;
+            }
+            uint64_t first = getPointIndex();
+            uint64_t size = UINT64_C(1) << m;
+            if (count > 0 && first + count <= size) {
+                fillParallel(first, out, count, layout, ld, threads);
+                if (first + count < size) {
+                    jumpTo(first + count);
+                } else {
+                    jumpTo(size - 1);
+                    nextPoint();
+                }
+                return;
+            }
+            if (layout == POINT_MAJOR) {
+                for (size_t i = 0; i < count; i++) {
+                    convertPoint(out + i * ld, 1);
+                    stepPoint();
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    convertPoint(out + i, ld);
+                    stepPoint();
+                }
+            }
+            convertPoint();
+        }
+
+        /**
+         * Writes points of index [first, first + count) into caller's
+         * buffer, without moving the cursor.
+         *
+         * Only base and digital shift are read, so many threads can call
+         * this for disjoint ranges at the same time.
+         * pointInitialize() should be called before this.
+         *
+         * Long ranges and NATURAL_ORDER are generated by the bit sliced
+         * engine, which makes 64 points at once for each coordinate, and
+         * others by walking gray code.
+         * Both engines work on a tile of coordinates for all points of
+         * the range before moving to the next tile, so that the working
+         * set stays in cache for large s, see setCoordinateTile().
+         * @param first index of the first point.
+         * @param out buffer, the same as fillPoints().
+         * @param count number of points, first + count <= 2^m.
+         * @param layout memory layout of \b out.
+         * @param ld leading dimension of \b out, should not be 0.
+         * @param order order of points.
+         */
+        void fillRange(uint64_t first, double out[], size_t count,
+                       point_layout layout, size_t ld,
+                       point_order order = GRAY_ORDER) const {
+            if (count == 0) {
+                return;
+            }
+            if (order == NATURAL_ORDER || count >= bit_sliced_threshold) {
+                fillBitSliced(first, out, count, layout, ld, order);
+                return;
+            }
+            size_t dp = (layout == POINT_MAJOR) ? ld : 1;
+            size_t stride = (layout == POINT_MAJOR) ? 1 : ld;
+            uint32_t w = std::min(tile, s);
+            U * pb = new U[w];
+            for (uint32_t j0 = 0; j0 < s; j0 += w) {
+                uint32_t width = std::min(w, s - j0);
+                for (uint32_t j = 0; j < width; j++) {
+                    pb[j] = 0;
+                }
+                addRows(first ^ (first >> 1), pb, j0, width);
+                double * p = out + j0 * stride;
+                for (size_t i = 0; ; i++) {
+                    convert(pb, j0, width, p + i * dp, stride);
+                    if (i + 1 == count) {
+                        break;
+                    }
+                    int bit = tailingZeroBit(first + i + 1);
+                    xorArray(pb, base + getIndex(bit, j0), width);
+                }
+            }
+            delete[] pb;
+        }
+
+        /**
+         * Draws a digital shift from the random number generator,
+         * the same as pointInitialize() does when digital shift is on.
+         * Shifts drawn by successive calls are those of successive
+         * replicates by setDigitalShift(true) and pointInitialize().
+         * @param out s elements of digital shift
+         */
+        void drawDigitalShift(U out[]) {
+            for (uint32_t i = 0; i < s; ++i) {
+                out[i] = mt();
+            }
+        }
+
+        /**
+         * Writes points of index [first, first + count) of
+         * \b replicates digitally shifted replicates, walking gray code
+         * only once. Each row of base is read once for all replicates,
+         * and the replicates differ only in conversion to double.
+         *
+         * The cursor is not moved and the digital shift of the net is
+         * not used. Coordinates are generated tile by tile, the same
+         * as fillRange(), see setCoordinateTile().
+         * @param first index of the first point.
+         * @param out buffer, point i of replicate r is written at
+         * out[(r * count + i) * s], replicates * count * s doubles.
+         * @param count number of points, first + count <= 2^m.
+         * @param replicates number of replicates.
+         * @param shifts digital shifts, shifts[r * s + j] for coordinate
+         * j of replicate r.
+         * @param seeds seeds of Owen scrambling in the same layout as
+         * \b shifts, NULL for no scrambling.
+         */
+        void fillReplicates(uint64_t first, double out[], size_t count,
+                            uint32_t replicates, const U shifts[],
+                            const U seeds[] = NULL) const {
+            if (count == 0) {
+                return;
+            }
+            uint32_t w = std::min(tile, s);
+            U * pb = new U[w];
+            for (uint32_t j0 = 0; j0 < s; j0 += w) {
+                uint32_t width = std::min(w, s - j0);
+                for (uint32_t j = 0; j < width; j++) {
+                    pb[j] = 0;
+                }
+                addRows(first ^ (first >> 1), pb, j0, width);
+                for (size_t i = 0; ; i++) {
+                    for (uint32_t r = 0; r < replicates; r++) {
+                        double * p = out + (r * count + i) * s + j0;
+                        const U * sh = shifts + r * s + j0;
+                        if (seeds == NULL) {
+                            convertArray(p, pb, sh, width);
+                        } else {
+                            owenConvertArray(p, pb, sh, seeds + r * s + j0,
+                                             width);
+                        }
+                    }
+                    if (i + 1 == count) {
+                        break;
+                    }
+                    int bit = tailingZeroBit(first + i + 1);
+                    xorArray(pb, base + getIndex(bit, j0), width);
+                }
+            }
+            delete[] pb;
+        }
+
+        /**
+         * Sets the number of coordinates generated together by
+         * fillRange() and fillReplicates(). Smaller tiles use less
+         * cache, larger tiles make longer inner loops.
+         * @param value number of coordinates in a tile, 0 means s.
+         */
+        void setCoordinateTile(uint32_t value) {
+            if (value == 0) {
+                tile = s;
+            } else {
+                tile = value;
+            }
+        }
+        //void showStatus(std::ostream& os);
+        void setSeed(U seed) {
+            mt.seed(seed);
+        }
+
+        /**
+         * Restarts the random number generator of digital shifts and
+         * scrambling from the state of \b generator, e.g. one of
+         * non-overlapping streams made by MersenneTwister64::stream
+         * once and reused, since jumping to a stream is slow.
+         * @param generator generator whose state is copied.
+         */
+        void setShiftGenerator(const MersenneTwister64& generator) {
+            mt = generator;
+        }
+        double getWAFOM() {
+            return wafom;
+        }
+
+        int64_t getTvalue() {
+            return tvalue;
+        }
+    private:
+        void setBase(int i, int j, U value) {
+            base[i * s + j] = value;
+        }
+        int getIndex(int i, int j) const {
+            return i * s + j;
+        }
+        /*
+         * moves point_base to the next point in gray code order,
+         * point is not updated.
+         */
+        void stepPoint() {
             if (count == (UINT64_C(1) << m)) {
                 pointInitialize();
                 //return;
             }
             int bit = gray.index();
 #if defined(DEBUG)
+            using namespace std;
             cout << "bit = " << bit << endl;
             cout << "before boint_base:" << endl;
             for (size_t i = 0; i < s; i++) {
@@ -361,10 +729,7 @@ namespace DigitalNetNS {
             }
             cout << endl;
 #endif
-            for (uint32_t i = 0; i < s; ++i) {
-                point_base[i] ^= getBase(bit, i);
-            }
-            convertPoint();
+            xorArray(point_base, base + getIndex(bit, 0), s);
             if (count == (UINT64_C(1) << m)) {
                 count = 0;
                 gray.clear();
@@ -378,50 +743,213 @@ namespace DigitalNetNS {
                 cout << point_base[i] << " ";
             }
             cout << endl;
-            cout << "out nextPoint" << endl;
 #endif
         }
-        //void showStatus(std::ostream& os);
-        void setSeed(U seed) {
-            mt.seed(seed);
+        void convertPoint() {
+            convertPoint(point, 1);
         }
-        double getWAFOM() {
-            return wafom;
+        void convertPoint(double out[], size_t stride) const {
+            convert(point_base, out, stride);
         }
-
-        int64_t getTvalue() {
-            return tvalue;
+        void convert(const U pb[], double out[], size_t stride) const {
+            convert(pb, 0, s, out, stride);
         }
-    private:
-        void setBase(int i, int j, U value) {
-            base[i * s + j] = value;
+        /*
+         * converts pb[0, width), which is coordinates [j0, j0 + width).
+         */
+        void convert(const U pb[], uint32_t j0, uint32_t width,
+                     double out[], size_t stride) const {
+            if (stride == 1) {
+                convertXor(out, pb, shift + j0, j0, width);
+                return;
+            }
+            for (uint32_t i = 0; i < width; i++) {
+                U x = scrambleCoordinate(pb[i] ^ shift[j0 + i], j0 + i);
+                out[i * stride] = toDouble(x);
+            }
         }
-        int getIndex(int i, int j) const {
-            return i * s + j;
+        /*
+         * out[i] = x[i] ^ y[i] of coordinate j0 + i converted to double.
+         */
+        void convertXor(double out[], const U x[], const U y[],
+                        uint32_t j0, uint32_t width) const {
+            if (owenScrambling) {
+                owenConvertArray(out, x, y, owen_seed + j0, width);
+            } else {
+                convertArray(out, x, y, width);
+            }
         }
-        void convertPoint() {
-            for (uint32_t i = 0; i < s; i++) {
-                // shift して1を立てている
-                uint64_t tmp = (point_base[i] ^ shift[i]) >> get_max;
-                point[i] = static_cast<double>(tmp) * factor + eps;
+        /*
+         * Owen scrambling of x of coordinate j, if it is on.
+         */
+        U scrambleCoordinate(U x, uint32_t j) const {
+            if (owenScrambling) {
+                return owenScramble(x, owen_seed[j]);
+            } else {
+                return x;
+            }
+        }
+        void fillParallel(uint64_t first, double out[], size_t count,
+                          point_layout layout, size_t ld, int threads) const {
+            if (threads <= 1) {
+                fillRange(first, out, count, layout, ld);
+                return;
+            }
+            size_t dp = (layout == POINT_MAJOR) ? ld : 1;
+            size_t chunk = (count + threads - 1) / threads;
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+            for (int t = 0; t < threads; t++) {
+                size_t start = chunk * t;
+                if (start < count) {
+                    size_t size = std::min(chunk, count - start);
+                    fillRange(first + start, out + start * dp, size,
+                              layout, ld);
+                }
+            }
+        }
+        /*
+         * out[i] ^= base rows selected by bits of code.
+         */
+        void addRows(uint64_t code, U out[]) const {
+            addRows(code, out, 0, s);
+        }
+        /*
+         * the same as above, only for coordinates [j0, j0 + width).
+         */
+        void addRows(uint64_t code, U out[], uint32_t j0,
+                     uint32_t width) const {
+            for (uint32_t k = 0; k < m; k++) {
+                if ((code >> k) & 1) {
+                    xorArray(out, base + getIndex(k, j0), width);
+                }
             }
         }
+
+        static uint64_t pointCode(uint64_t index, point_order order) {
+            if (order == GRAY_ORDER) {
+                return index ^ (index >> 1);
+            } else {
+                return index;
+            }
+        }
+
+        /*
+         * Bit sliced engine.
+         *
+         * Write i = 64 q + t, t < 64. The code (gray code or i itself)
+         * of i is code(64 q) ^ code(t), so i-th point is high(q) ^ low(t),
+         * where low(t) is a linear combination of the first six rows of
+         * base. The 64 values of low(t) are computed at once for each
+         * coordinate by linearCombination64(), and high(q) is updated only
+         * once every 64 points, so there is no dependency chain from a
+         * point to the next.
+         */
+        void fillBitSliced(uint64_t first, double out[], size_t count,
+                           point_layout layout, size_t ld,
+                           point_order order) const {
+            const int low = std::min<int>(m, 6);
+            uint64_t select[6];
+            for (int r = 0; r < low; r++) {
+                uint64_t x = 0;
+                for (uint64_t t = 0; t < 64; t++) {
+                    x |= ((pointCode(t, order) >> r) & 1) << t;
+                }
+                select[r] = x;
+            }
+            const uint64_t last = first + count;
+            U rows[6];
+            U col[64];
+            if (layout == POINT_MAJOR) {
+                uint32_t w = std::min(tile, s);
+                // table[t * w + j] is low(t) of (j0 + j)-th coordinate
+                // with shift
+                U * table = new U[64 * w];
+                U * high = new U[w];
+                for (uint32_t j0 = 0; j0 < s; j0 += w) {
+                    uint32_t width = std::min(w, s - j0);
+                    for (uint32_t j = 0; j < width; j++) {
+                        for (int r = 0; r < low; r++) {
+                            rows[r] = getBase(r, j0 + j);
+                        }
+                        linearCombination64(col, rows, low, select);
+                        for (int t = 0; t < 64; t++) {
+                            table[t * width + j] = col[t] ^ shift[j0 + j];
+                        }
+                        high[j] = 0;
+                    }
+                    uint64_t q = first >> 6;
+                    addRows(pointCode(q << 6, order), high, j0, width);
+                    double * p = out + j0;
+                    for (uint64_t i = first; i < last; q++) {
+                        uint64_t end = std::min((q + 1) << 6, last);
+                        for (; i < end; i++) {
+                            convertXor(p, high, table + (i & 63) * width,
+                                       j0, width);
+                            p += ld;
+                        }
+                        if (i < last) {
+                            addRows(pointCode((q + 1) << 6, order)
+                                    ^ pointCode(q << 6, order),
+                                    high, j0, width);
+                        }
+                    }
+                }
+                delete[] high;
+                delete[] table;
+            } else {
+                // one coordinate for all points, then the next coordinate
+                for (uint32_t j = 0; j < s; j++) {
+                    for (int r = 0; r < low; r++) {
+                        rows[r] = getBase(r, j);
+                    }
+                    linearCombination64(col, rows, low, select);
+                    uint64_t q = first >> 6;
+                    U high = shift[j] ^ columnRows(pointCode(q << 6, order), j);
+                    double * p = out + j * ld;
+                    for (uint64_t i = first; i < last; q++) {
+                        uint64_t end = std::min((q + 1) << 6, last);
+                        for (; i < end; i++) {
+                            U x = scrambleCoordinate(high ^ col[i & 63], j);
+                            *p++ = toDouble(x);
+                        }
+                        high ^= columnRows(pointCode((q + 1) << 6, order)
+                                           ^ pointCode(q << 6, order), j);
+                    }
+                }
+            }
+        }
+
+        /*
+         * j-th coordinate of base rows selected by bits of code.
+         */
+        U columnRows(uint64_t code, uint32_t j) const {
+            U x = 0;
+            for (uint32_t k = 0; k < m && (code >> k) != 0; k++) {
+                if ((code >> k) & 1) {
+                    x ^= getBase(k, j);
+                }
+            }
+            return x;
+        }
+
         int id;
         uint32_t s;
         uint32_t m;
+        uint32_t tile;
         uint64_t count;
         double wafom;
         int tvalue;
         bool digitalShift;
         bool shiftVector;
-        int get_max;
-        double factor;
-        double eps;
+        bool owenScrambling;
         GrayIndex gray;
         MersenneTwister64 mt;
         U * base;
         U * point_base;
         U * shift;
+        U * owen_seed;
         double * point;
     };
 
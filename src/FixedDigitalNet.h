@@ -0,0 +1,310 @@
+#pragma once
+#ifndef FIXED_DIGITAL_NET_H
+#define FIXED_DIGITAL_NET_H
+/**
+ * @file FixedDigitalNet.h
+ *
+ * @brief DigitalNet whose s and m are fixed at compile time.
+ *
+ * For small s, loop overhead and pointer chasing of DigitalNet dominate
+ * point generation. FixedDigitalNet keeps all arrays inline with cache
+ * line alignment, and its loops over s are unrolled.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "DigitalNet.h"
+#include "grayindex.h"
+#include "MersenneTwister64.h"
+#include "simd_kernel.h"
+#include <stdint.h>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace DigitalNetNS {
+
+    /*
+     * Unroll<N>::run(f) calls f(0), f(1), ..., f(N - 1).
+     */
+    template<uint32_t N>
+    struct Unroll {
+        template<typename F>
+        static void run(F& f) {
+            Unroll<N - 1>::run(f);
+            f(N - 1);
+        }
+    };
+
+    template<>
+    struct Unroll<0> {
+        template<typename F>
+        static void run(F&) {
+        }
+    };
+
+    /**
+     * Digital net of fixed dimension S and F2-dimension M.
+     *
+     * This has the same interface and generates the same points as
+     * DigitalNet<U> for point generation, and is made from a DigitalNet<U>
+     * whose s and m are S and M.
+     * Its random number generator for digital shift starts from the
+     * default seed, the same as a new DigitalNet<U>.
+     */
+    template<typename U, uint32_t S, uint32_t M>
+    class FixedDigitalNet {
+    private:
+        // First of all, forbid copy and assign.
+        FixedDigitalNet(const FixedDigitalNet<U, S, M>& that);
+        FixedDigitalNet<U, S, M>& operator=(const FixedDigitalNet<U, S, M>&);
+
+    public:
+        /**
+         * Constructor from DigitalNet
+         * @param dn digital net, s and m should be S and M.
+         * @exception when s or m of \b dn differs.
+         */
+        FixedDigitalNet(const DigitalNet<U>& dn) {
+            if (dn.getS() != S || dn.getM() != M) {
+                throw "s and m mismatch!";
+            }
+            dn.saveBase(base, S * M);
+            for (uint32_t i = 0; i < S; i++) {
+                shift[i] = 0;
+                point_base[i] = 0;
+                point[i] = 0;
+            }
+            count = 0;
+            digitalShift = false;
+        }
+
+        U getBase(int i, int j) const {
+            return base[i * S + j];
+        }
+
+        void saveBase(U save[], size_t size) const {
+            for (size_t i = 0; (i < S * M) && (i < size); i++) {
+                save[i] = base[i];
+            }
+        }
+
+        void restoreBase(const U save[], size_t size) {
+            for (size_t i = 0; (i < S * M) && (i < size); i++) {
+                base[i] = save[i];
+            }
+        }
+
+        /**
+         * see DigitalNet::scramble.
+         */
+        void scramble() {
+            for (uint32_t i = 0; i < S; i++) {
+                linearScramble(base + i, M, S, mt);
+            }
+        }
+
+        double getPoint(int i) const {
+            return point[i];
+        }
+
+        const double * getPoint() const {
+            return point;
+        }
+
+        void setDigitalShift(bool value) {
+            digitalShift = value;
+        }
+
+        uint32_t getS() const {
+            return S;
+        }
+
+        uint32_t getM() const {
+            return M;
+        }
+
+        uint64_t getPointIndex() const {
+            return count - 1;
+        }
+
+        void pointInitialize() {
+            for (uint32_t i = 0; i < S; ++i) {
+                point_base[i] = 0;
+            }
+            if (digitalShift) {
+                drawDigitalShift(shift);
+            } else {
+                for (uint32_t i = 0; i < S; ++i) {
+                    shift[i] = 0;
+                }
+            }
+            gray.clear();
+            count = 1;
+            convertPoint(point);
+        }
+
+        void nextPoint() {
+            stepPoint();
+            convertPoint(point);
+        }
+
+        /**
+         * Block version of getPoint() and nextPoint(),
+         * see DigitalNet::fillPoints.
+         * @param out buffer for points.
+         * @param count number of points to be written.
+         * @param layout memory layout of \b out.
+         * @param ld leading dimension of \b out, 0 means S for POINT_MAJOR
+         * and count for COORDINATE_MAJOR.
+         */
+        void fillPoints(double out[], size_t count,
+                        point_layout layout = POINT_MAJOR, size_t ld = 0) {
+            if (layout == POINT_MAJOR) {
+                if (ld == 0) {
+                    ld = S;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    convertPoint(out + i * ld);
+                    stepPoint();
+                }
+            } else {
+                if (ld == 0) {
+                    ld = count;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    convertPoint(out + i, ld);
+                    stepPoint();
+                }
+            }
+            convertPoint(point);
+        }
+
+        /**
+         * see DigitalNet::drawDigitalShift.
+         */
+        void drawDigitalShift(U out[]) {
+            for (uint32_t i = 0; i < S; ++i) {
+                out[i] = mt();
+            }
+        }
+
+        /**
+         * see DigitalNet::fillReplicates.
+         */
+        void fillReplicates(uint64_t first, double out[], size_t count,
+                            uint32_t replicates, const U shifts[],
+                            const U seeds[] = NULL) const {
+            if (count == 0) {
+                return;
+            }
+            alignas(64) U pb[S];
+            for (uint32_t i = 0; i < S; ++i) {
+                pb[i] = 0;
+            }
+            uint64_t g = first ^ (first >> 1);
+            for (uint32_t k = 0; g != 0; k++, g >>= 1) {
+                if (g & 1) {
+                    XorRow f = {pb, base + k * S};
+                    Unroll<S>::run(f);
+                }
+            }
+            for (size_t i = 0; ; i++) {
+                for (uint32_t r = 0; r < replicates; r++) {
+                    if (seeds == NULL) {
+                        Convert f = {pb, shifts + r * S,
+                                     out + (r * count + i) * S, 1};
+                        Unroll<S>::run(f);
+                    } else {
+                        OwenConvert f = {pb, shifts + r * S, seeds + r * S,
+                                         out + (r * count + i) * S};
+                        Unroll<S>::run(f);
+                    }
+                }
+                if (i + 1 == count) {
+                    break;
+                }
+                XorRow f = {pb, base + tailingZeroBit(first + i + 1) * S};
+                Unroll<S>::run(f);
+            }
+        }
+
+        void setSeed(U seed) {
+            mt.seed(seed);
+        }
+
+        /**
+         * see DigitalNet::setShiftGenerator.
+         */
+        void setShiftGenerator(const MersenneTwister64& generator) {
+            mt = generator;
+        }
+
+    private:
+        struct XorRow {
+            U * pb;
+            const U * row;
+            void operator()(uint32_t i) const {
+                pb[i] ^= row[i];
+            }
+        };
+
+        struct Convert {
+            const U * pb;
+            const U * shift;
+            double * out;
+            size_t stride;
+            void operator()(uint32_t i) const {
+                out[i * stride] = toDouble(static_cast<U>(pb[i] ^ shift[i]));
+            }
+        };
+
+        struct OwenConvert {
+            const U * pb;
+            const U * shift;
+            const U * seed;
+            double * out;
+            void operator()(uint32_t i) const {
+                out[i] = toDouble(owenScramble(static_cast<U>(pb[i] ^ shift[i]),
+                                               seed[i]));
+            }
+        };
+
+        void stepPoint() {
+            if (count == (UINT64_C(1) << M)) {
+                pointInitialize();
+            }
+            XorRow f = {point_base, base + gray.index() * S};
+            Unroll<S>::run(f);
+            if (count == (UINT64_C(1) << M)) {
+                count = 0;
+                gray.clear();
+            } else {
+                gray.next();
+                count++;
+            }
+        }
+
+        void convertPoint(double out[], size_t stride = 1) const {
+            Convert f = {point_base, shift, out, stride};
+            Unroll<S>::run(f);
+        }
+
+        alignas(64) U base[S * M];
+        alignas(64) U point_base[S];
+        alignas(64) U shift[S];
+        alignas(64) double point[S];
+        uint64_t count;
+        bool digitalShift;
+        GrayIndex gray;
+        MersenneTwister64 mt;
+    };
+}
+#endif // FIXED_DIGITAL_NET_H
@@ -0,0 +1,223 @@
+/**
+ * @file Integrand.cpp
+ *
+ * @brief integrand called by integration drivers.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "Integrand.h"
+#include <algorithm>
+
+// [[Rcpp::plugins(cpp11)]]
+
+using namespace std;
+using namespace Rcpp;
+
+namespace rmcqmcint {
+
+    Integrand::Integrand(SEXP integrand, int s, bool vectorized,
+                         int outputs, SEXP params) : nv(s)
+    {
+        this->s = s;
+        this->outputs = outputs;
+        this->vectorized = vectorized;
+        antithetic = false;
+        function = integrand;
+        native = NULL;
+        P = 0;
+        q = 0;
+        if (!Rf_isNull(params)) {
+            NumericMatrix mat(params);
+            P = mat.nrow();
+            q = mat.ncol();
+            if (P < 1) {
+                Rcpp::stop("params should have at least one row.");
+            }
+            theta.resize(P * q);
+            for (int p = 0; p < P; p++) {
+                NumericVector row(q);
+                for (int j = 0; j < q; j++) {
+                    theta[p * q + j] = mat(p, j);
+                    row[j] = mat(p, j);
+                }
+                rows.push_back(row);
+            }
+            this->outputs = P;
+        }
+        if (TYPEOF(integrand) == EXTPTRSXP) {
+            if (R_ExternalPtrTag(integrand)
+                != Rf_install(native_integrand_tag)) {
+                Rcpp::stop("external pointer is not made by"
+                           " rmcqmcint::wrapNativeIntegrand.");
+            }
+            XPtr<NativeIntegrand> ptr(integrand);
+            native = ptr.get();
+            if (native != NULL && P > 0) {
+                if (native->parametric == NULL) {
+                    Rcpp::stop("integrand has no parametric function.");
+                }
+                return;
+            }
+            if (native == NULL
+                || (native->scalar == NULL && native->block == NULL)) {
+                Rcpp::stop("integrand has no function.");
+            }
+            this->outputs = native->outputs;
+            if (native->outputs < 1
+                || (native->outputs > 1 && native->block == NULL)) {
+                Rcpp::stop("vector valued integrand should have block.");
+            }
+        } else if (!Rf_isFunction(integrand)) {
+            Rcpp::stop("integrand should be a function or an external"
+                       " pointer to NativeIntegrand.");
+        }
+    }
+
+    void Integrand::evaluate(const double x[], size_t n, double out[])
+    {
+        if (!antithetic) {
+            evaluatePoints(x, n, out);
+            return;
+        }
+        // x_0, ..., x_(n - 1), 1 - x_0, ..., 1 - x_(n - 1)
+        pairPoints.resize(2 * n * s);
+        copy(x, x + n * s, pairPoints.begin());
+        for (size_t i = 0; i < n * s; i++) {
+            pairPoints[n * s + i] = 1.0 - x[i];
+        }
+        pairValues.resize(2 * n * outputs);
+        evaluatePoints(pairPoints.data(), 2 * n, pairValues.data());
+        for (size_t i = 0; i < n * outputs; i++) {
+            out[i] = (pairValues[i] + pairValues[n * outputs + i]) * 0.5;
+        }
+    }
+
+    /*
+     * f at n points, see evaluate().
+     */
+    void Integrand::evaluatePoints(const double x[], size_t n, double out[])
+    {
+        if (P > 0) {
+            evaluateSweep(x, n, out);
+            return;
+        }
+        if (native != NULL) {
+            if (native->block != NULL) {
+                native->block(x, static_cast<int>(n), s, out, native->data);
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = native->scalar(x + i * s, s, native->data);
+                }
+            }
+            return;
+        }
+        if (vectorized) {
+            evaluateMatrix(x, n, out);
+            return;
+        }
+        Function f(function);
+        if (outputs == 1) {
+            for (size_t i = 0; i < n; i++) {
+                copy(x + i * s, x + i * s + s, nv.begin());
+                out[i] = as<double>(f(nv));
+#if defined(DEBUG)
+                cout << "d:" << out[i] << endl;
+#endif
+            }
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            copy(x + i * s, x + i * s + s, nv.begin());
+            NumericVector r = f(nv);
+            if (static_cast<int>(r.size()) != outputs) {
+                Rcpp::stop("integrand should return as many values"
+                           " as outputs.");
+            }
+            copy(r.begin(), r.end(), out + i * outputs);
+        }
+    }
+
+    /*
+     * calls vectorized R function with n x s matrix, which returns
+     * n values or n x outputs matrix.
+     */
+    void Integrand::evaluateMatrix(const double x[], size_t n, double out[])
+    {
+        setMatrix(x, n);
+        Function f(function);
+        NumericVector r = f(matrix);
+        if (static_cast<size_t>(r.size()) != n * outputs) {
+            Rcpp::stop("vectorized integrand should return as many values"
+                       " as rows of the matrix times outputs.");
+        }
+        for (int k = 0; k < outputs; k++) {
+            for (size_t i = 0; i < n; i++) {
+                out[i * outputs + k] = r[k * n + i];
+            }
+        }
+    }
+
+    /*
+     * out[i * P + p] = f(x_i, theta_p), P calls of parametric function
+     * for a block.
+     */
+    void Integrand::evaluateSweep(const double x[], size_t n, double out[])
+    {
+        if (native != NULL) {
+            work.resize(n);
+            for (int p = 0; p < P; p++) {
+                native->parametric(x, static_cast<int>(n), s, &theta[p * q],
+                                   q, work.data(), native->data);
+                for (size_t i = 0; i < n; i++) {
+                    out[i * P + p] = work[i];
+                }
+            }
+            return;
+        }
+        Function f(function);
+        if (vectorized) {
+            setMatrix(x, n);
+            for (int p = 0; p < P; p++) {
+                NumericVector r = f(matrix, rows[p]);
+                if (static_cast<size_t>(r.size()) != n) {
+                    Rcpp::stop("vectorized integrand should return as many"
+                               " values as rows of the matrix.");
+                }
+                for (size_t i = 0; i < n; i++) {
+                    out[i * P + p] = r[i];
+                }
+            }
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            copy(x + i * s, x + i * s + s, nv.begin());
+            for (int p = 0; p < P; p++) {
+                out[i * P + p] = as<double>(f(nv, rows[p]));
+            }
+        }
+    }
+
+    /*
+     * n x s matrix of n points for vectorized R function.
+     */
+    void Integrand::setMatrix(const double x[], size_t n)
+    {
+        if (static_cast<size_t>(matrix.nrow()) != n) {
+            matrix = NumericMatrix(n, s);
+        }
+        for (int j = 0; j < s; j++) {
+            for (size_t i = 0; i < n; i++) {
+                matrix(i, j) = x[i * s + j];
+            }
+        }
+    }
+}
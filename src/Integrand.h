@@ -0,0 +1,113 @@
+#pragma once
+#ifndef INTEGRAND_H
+#define INTEGRAND_H
+/**
+ * @file Integrand.h
+ *
+ * @brief integrand called by integration drivers.
+ *
+ * Integrand is an R function or an external pointer to NativeIntegrand,
+ * the driver calls evaluate() for a block of points in both cases.
+ * Vectorized R function receives a block of points as a matrix.
+ * Integrand may be vector valued, that is, have several outputs.
+ * Parametric integrand f(x, theta) with P rows of parameters is
+ * regarded as an integrand with P outputs.
+ * Antithetic integrand evaluates f at each point x and at its
+ * reflection 1 - x, and gives their average.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <Rcpp.h>
+#include <rmcqmcint.h>
+#include <vector>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace rmcqmcint {
+
+    class Integrand {
+    public:
+        /**
+         * Constructor
+         * @param integrand R function or external pointer to
+         * NativeIntegrand.
+         * @param s dimension.
+         * @param vectorized true if R function receives n x s matrix
+         * of n points and returns n values, or n x outputs matrix.
+         * @param outputs number of outputs of R function, compiled
+         * integrand has its own.
+         * @param params NULL or P x q matrix, p-th output is
+         * f(x, params[p, ]).
+         */
+        Integrand(SEXP integrand, int s, bool vectorized = false,
+                  int outputs = 1, SEXP params = R_NilValue);
+
+        /**
+         * out[i * K + k] = f_k(x[i * s], ..., x[i * s + s - 1])
+         * for 0 <= i < n and 0 <= k < K, K = getOutputs().
+         * R function is called for each point, or once for all points
+         * if vectorized, and compiled integrand is called directly.
+         * @param x n points.
+         * @param n number of points.
+         * @param out n values.
+         */
+        void evaluate(const double x[], size_t n, double out[]);
+
+        /**
+         * When \b value is true, evaluate() gives
+         * (f(x) + f(1 - x)) / 2 instead of f(x), by one call of R
+         * function or compiled integrand for the block of 2n points.
+         * For points of a digital net, 1 - x is the digital
+         * reflection, every bit of x complemented, because toDouble()
+         * gives the center of each interval.
+         * @param value true for antithetic evaluation.
+         */
+        void setAntithetic(bool value) {
+            antithetic = value;
+        }
+
+        bool isAntithetic() const {
+            return antithetic;
+        }
+
+        bool isNative() const {
+            return native != NULL;
+        }
+
+        int getOutputs() const {
+            return outputs;
+        }
+    private:
+        void evaluatePoints(const double x[], size_t n, double out[]);
+        void evaluateMatrix(const double x[], size_t n, double out[]);
+        void evaluateSweep(const double x[], size_t n, double out[]);
+        void setMatrix(const double x[], size_t n);
+        int s;
+        int outputs;
+        bool vectorized;
+        bool antithetic;
+        SEXP function;
+        NativeIntegrand * native;
+        Rcpp::NumericVector nv;
+        Rcpp::NumericMatrix matrix;
+        // parameters of sweep, P rows of q doubles
+        int P;
+        int q;
+        std::vector<double> theta;
+        std::vector<Rcpp::NumericVector> rows;
+        std::vector<double> work;
+        // points and values of antithetic pairs
+        std::vector<double> pairPoints;
+        std::vector<double> pairValues;
+    };
+}
+#endif // INTEGRAND_H
@@ -0,0 +1,356 @@
+/**
+ * @file MersenneTwister64.cpp
+ *
+ *\japanese
+ * @brief 64bit MersenneTwister の jump-ahead
+ *\endjapanese
+ *
+ *\english
+ * @brief jump-ahead of 64 bit MersenneTwister generator
+ *
+ * The characteristic polynomial phi(t) of the state transition F is
+ * computed once by Berlekamp-Massey algorithm from output bits. Jump
+ * by J outputs computes r(t) = t^J mod phi(t), and the new state is
+ * r(F) applied to the current state.
+ * See H. Haramoto, M. Matsumoto, T. Nishimura, F. Panneton and
+ * P. L'Ecuyer, "Efficient Jump Ahead for F2-Linear Random Number
+ * Generators", INFORMS Journal on Computing 20(3), 2008.
+ *\endenglish
+ *
+ * @author Mutsuo Saito
+ * @author Makoto Matsumoto (Hiroshima University)
+ * Copyright (C) 2017 Mutsuo Saito, Makoto Matsumoto and Hiroshima
+ * University. All rights reserved.
+ *
+ * The 3-clause BSD License is applied to this software, see
+ * LICENSE.txt
+ */
+#include "MersenneTwister64.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+// [[Rcpp::plugins(cpp11)]]
+
+using namespace std;
+
+namespace {
+    // polynomial over F2, bit i of word i / 64 is coefficient of t^i.
+    typedef vector<uint64_t> polynomial;
+
+    const int mexp = 19937;
+    const int poly_words = mexp / 64 + 1;
+    // steps shorter than this are skipped by next()
+    const uint64_t discard_by_next = 4 * mexp;
+
+    inline int getBit(const polynomial& p, int i) {
+        return static_cast<int>((p[i / 64] >> (i % 64)) & 1);
+    }
+
+    inline void flipBit(polynomial& p, int i) {
+        p[i / 64] ^= UINT64_C(1) << (i % 64);
+    }
+
+    inline int parity(uint64_t x) {
+        x ^= x >> 32;
+        x ^= x >> 16;
+        x ^= x >> 8;
+        x ^= x >> 4;
+        x ^= x >> 2;
+        x ^= x >> 1;
+        return static_cast<int>(x & 1);
+    }
+
+    /*
+     * 64 bits of p from bit pos, bits beyond p are 0.
+     */
+    inline uint64_t getWord(const polynomial& p, size_t pos) {
+        size_t w = pos / 64;
+        int b = pos % 64;
+        uint64_t x = (w < p.size()) ? p[w] >> b : 0;
+        if (b != 0 && w + 1 < p.size()) {
+            x |= p[w + 1] << (64 - b);
+        }
+        return x;
+    }
+
+    /*
+     * p ^= q * t^shift
+     */
+    void xorShifted(polynomial& p, const polynomial& q, size_t shift) {
+        size_t w = shift / 64;
+        int b = shift % 64;
+        for (size_t i = 0; i < q.size() && i + w < p.size(); i++) {
+            p[i + w] ^= q[i] << b;
+            if (b != 0 && i + w + 1 < p.size()) {
+                p[i + w + 1] ^= q[i] >> (64 - b);
+            }
+        }
+    }
+
+    /*
+     * Minimal polynomial of bit sequence s of length n, by
+     * Berlekamp-Massey algorithm. The connection polynomial
+     * C(x) = 1 + c_1 x + ... + c_L x^L, s_i = sum c_j s_(i - j),
+     * is reversed to t^L + c_1 t^(L - 1) + ... + c_L.
+     */
+    polynomial berlekampMassey(const polynomial& s, int n, int * degree) {
+        // reversed sequence, bit n - 1 - i of r is s_i
+        polynomial r(s.size(), 0);
+        for (int i = 0; i < n; i++) {
+            if (getBit(s, i)) {
+                flipBit(r, n - 1 - i);
+            }
+        }
+        polynomial c(s.size(), 0);
+        polynomial b(s.size(), 0);
+        c[0] = 1;
+        b[0] = 1;
+        int L = 0;
+        int m = 1;
+        for (int i = 0; i < n; i++) {
+            // d = s_i + sum c_j s_(i - j) = sum c_j r_(n - 1 - i + j)
+            int d = 0;
+            size_t base = n - 1 - i;
+            for (int j = 0; j <= L; j += 64) {
+                d ^= parity(c[j / 64] & getWord(r, base + j));
+            }
+            if (d == 0) {
+                m++;
+            } else if (2 * L <= i) {
+                polynomial t = c;
+                xorShifted(c, b, m);
+                L = i + 1 - L;
+                b = t;
+                m = 1;
+            } else {
+                xorShifted(c, b, m);
+                m++;
+            }
+        }
+        polynomial phi(L / 64 + 1, 0);
+        for (int j = 0; j <= L; j++) {
+            if (getBit(c, j)) {
+                flipBit(phi, L - j);
+            }
+        }
+        *degree = L;
+        return phi;
+    }
+
+    /*
+     * characteristic polynomial of MT19937-64 and its 64 shifts,
+     * shifted[b] is phi * t^b.
+     */
+    struct Characteristic {
+        Characteristic() {
+            MersenneTwister64 mt;
+            int n = 2 * mexp;
+            polynomial s(n / 64 + 1, 0);
+            for (int i = 0; i < n; i++) {
+                if (mt.next() & 1) {
+                    flipBit(s, i);
+                }
+            }
+            int degree;
+            polynomial phi = berlekampMassey(s, n, &degree);
+            if (degree != mexp) {
+                throw runtime_error("characteristic polynomial not found");
+            }
+            for (int b = 0; b < 64; b++) {
+                shifted[b].assign(poly_words + 1, 0);
+                xorShifted(shifted[b], phi, b);
+            }
+        }
+        polynomial shifted[64];
+    };
+
+    const Characteristic& characteristic() {
+        static const Characteristic phi;
+        return phi;
+    }
+
+    /*
+     * p mod phi, p has at most 2 * poly_words words.
+     */
+    polynomial reduce(polynomial p) {
+        const Characteristic& phi = characteristic();
+        for (int i = static_cast<int>(p.size()) * 64 - 1; i >= mexp; i--) {
+            if (getBit(p, i)) {
+                int shift = i - mexp;
+                const polynomial& q = phi.shifted[shift % 64];
+                size_t w = shift / 64;
+                for (size_t j = 0; j < q.size() && j + w < p.size(); j++) {
+                    p[j + w] ^= q[j];
+                }
+            }
+        }
+        p.resize(poly_words);
+        return p;
+    }
+
+    polynomial mulMod(const polynomial& a, const polynomial& b) {
+        polynomial shifted[64];
+        for (int k = 0; k < 64; k++) {
+            shifted[k].assign(poly_words + 1, 0);
+            xorShifted(shifted[k], b, k);
+        }
+        polynomial p(2 * poly_words + 1, 0);
+        for (int i = 0; i < mexp; i++) {
+            if (getBit(a, i)) {
+                const polynomial& q = shifted[i % 64];
+                size_t w = i / 64;
+                for (size_t j = 0; j < q.size(); j++) {
+                    p[j + w] ^= q[j];
+                }
+            }
+        }
+        return reduce(p);
+    }
+
+    polynomial squareMod(const polynomial& a) {
+        polynomial p(2 * poly_words, 0);
+        for (int i = 0; i < mexp; i++) {
+            if (getBit(a, i)) {
+                flipBit(p, 2 * i);
+            }
+        }
+        return reduce(p);
+    }
+
+    /*
+     * t^(2^k) mod phi
+     */
+    polynomial powerOfTwo(int k) {
+        polynomial p(poly_words, 0);
+        // t^(2^k) itself for 2^k < mexp
+        int k0 = 0;
+        while (k0 < k && (1 << (k0 + 1)) < mexp) {
+            k0++;
+        }
+        flipBit(p, 1 << k0);
+        for (int i = k0; i < k; i++) {
+            p = squareMod(p);
+        }
+        return p;
+    }
+
+    /*
+     * p^e mod phi
+     */
+    polynomial powerMod(const polynomial& p, uint64_t e) {
+        polynomial r(poly_words, 0);
+        r[0] = 1;
+        polynomial x = p;
+        while (e != 0) {
+            if (e & 1) {
+                r = mulMod(r, x);
+            }
+            e >>= 1;
+            if (e != 0) {
+                x = squareMod(x);
+            }
+        }
+        return r;
+    }
+}
+
+/*
+ * regenerates all words of the state, when mti is 0.
+ */
+void MersenneTwister64::generateBlock()
+{
+    int i = 0;
+    for (; i < N - M; i++) {
+        mt[i] = twist(mt[i + M], mt[i], mt[i + 1]);
+    }
+    for (; i < N - 1; i++) {
+        mt[i] = twist(mt[i + M - N], mt[i], mt[i + 1]);
+    }
+    mt[N - 1] = twist(mt[M - 1], mt[N - 1], mt[0]);
+}
+
+void MersenneTwister64::fill(uint64_t out[], size_t n)
+{
+    while (n > 0 && mti != 0) {
+        *out++ = next();
+        n--;
+    }
+    while (n >= static_cast<size_t>(N)) {
+        generateBlock();
+        for (int i = 0; i < N; i++) {
+            out[i] = temper(mt[i]);
+        }
+        out += N;
+        n -= N;
+    }
+    while (n > 0) {
+        *out++ = next();
+        n--;
+    }
+}
+
+void MersenneTwister64::fillDouble(double out[], size_t n)
+{
+    uint64_t buffer[N];
+    while (n > 0) {
+        size_t size = min(n, static_cast<size_t>(N));
+        fill(buffer, size);
+        for (size_t i = 0; i < size; i++) {
+            out[i] = static_cast<double>(buffer[i] >> 11)
+                * (1.0 / 9007199254740992.0);
+        }
+        out += size;
+        n -= size;
+    }
+}
+
+void MersenneTwister64::discard(uint64_t steps)
+{
+    if (steps < discard_by_next) {
+        for (uint64_t i = 0; i < steps; i++) {
+            next();
+        }
+        return;
+    }
+    polynomial t(poly_words, 0);
+    flipBit(t, 1);
+    polynomial r = powerMod(t, steps);
+    jumpByPolynomial(r.data(), mexp - 1);
+}
+
+void MersenneTwister64::jumpPow2(int k)
+{
+    polynomial r = powerOfTwo(k);
+    jumpByPolynomial(r.data(), mexp - 1);
+}
+
+void MersenneTwister64::stream(uint64_t index, int k)
+{
+    if (index == 0) {
+        return;
+    }
+    polynomial r = powerMod(powerOfTwo(k), index);
+    jumpByPolynomial(r.data(), mexp - 1);
+}
+
+/*
+ * state = poly(F) state, where F is the state transition, by adding
+ * F^i state for each nonzero coefficient of t^i.
+ */
+void MersenneTwister64::jumpByPolynomial(const uint64_t poly[], int degree)
+{
+    vector<uint64_t> sum(N, 0);
+    for (int i = 0; i <= degree; i++) {
+        if ((poly[i / 64] >> (i % 64)) & 1) {
+            for (int j = 0; j < N; j++) {
+                sum[j] ^= mt[(mti + j) % N];
+            }
+        }
+        next();
+    }
+    for (int j = 0; j < N; j++) {
+        mt[j] = sum[j];
+    }
+    mti = 0;
+}
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include <string>
+#include <cstddef>
 
 // [[Rcpp::plugins(cpp11)]]
 
@@ -126,6 +127,42 @@ public:
         delete[] mt;
     }
 
+    /**
+     *\japanese
+     * コピーコンストラクタ
+     * @param[in] other 状態をコピーする生成器
+     *\endjapanese
+     *
+     *\english
+     * Copy constructor, which copies the whole state, so that the
+     * copy returns the same outputs as \b other.
+     * @param[in] other generator whose state is copied
+     *\endenglish
+     */
+    MersenneTwister64(const MersenneTwister64& other) {
+        mt = new uint64_t[N];
+        *this = other;
+    }
+
+    /**
+     *\japanese
+     * 代入
+     * @param[in] other 状態をコピーする生成器
+     *\endjapanese
+     *
+     *\english
+     * Assignment, which copies the whole state.
+     * @param[in] other generator whose state is copied
+     *\endenglish
+     */
+    MersenneTwister64& operator=(const MersenneTwister64& other) {
+        for (int i = 0; i < N; i++) {
+            mt[i] = other.mt[i];
+        }
+        mti = other.mti;
+        return *this;
+    }
+
     /**
      *\japanese
      * 64bit整数による初期化
@@ -277,19 +314,53 @@ public:
      *\endenglish
      */
     uint64_t next() {
-        const uint64_t UPPER_MASK = UINT64_C(0xFFFFFFFF80000000);
-        const uint64_t LOWER_MASK = UINT64_C(0x000000007FFFFFFF);
-        const uint64_t mag01[2] = {0x0UL, UINT64_C(0xB5026F5AA96619E9)};
-        uint64_t x;
-
-        x = (mt[mti] & UPPER_MASK) | (mt[(mti + 1) % N] & LOWER_MASK);
-        mt[mti] = mt[(mti + M) % N] ^ (x >> 1)
-            ^ mag01[(int)(x & UINT64_C(1))];
-        x = mt[mti];
-        mti = (mti + 1) % N;
+        int next = mti + 1;
+        if (next == N) {
+            next = 0;
+        }
+        int mid = mti + M;
+        if (mid >= N) {
+            mid -= N;
+        }
+        uint64_t x = twist(mt[mid], mt[mti], mt[next]);
+        mt[mti] = x;
+        mti = next;
         return temper(x);
     }
 
+    /**
+     *\japanese
+     * 疑似乱数を n 個生成する
+     * @param[out] out 64bit符号なし整数の配列
+     * @param[in] n 生成する数
+     *\endjapanese
+     *
+     *\english
+     * Generates \b n pseudo random numbers, the same as \b n calls
+     * of next(). The whole state is regenerated at once by loops
+     * without modulo, which compilers vectorize.
+     * @param[out] out array of 64-bit unsigned integers
+     * @param[in] n number of outputs
+     *\endenglish
+     */
+    void fill(uint64_t out[], size_t n);
+
+    /**
+     *\japanese
+     * [0, 1) の一様疑似乱数を n 個生成する
+     * @param[out] out double の配列
+     * @param[in] n 生成する数
+     *\endjapanese
+     *
+     *\english
+     * Generates \b n uniform pseudo random numbers in [0, 1),
+     * upper 53 bits of fill() outputs divided by 2^53.
+     * @param[out] out array of doubles
+     * @param[in] n number of outputs
+     *\endenglish
+     */
+    void fillDouble(double out[], size_t n);
+
     /**
      *\japanese
      * 状態空間のビットサイズである 19937 を返す。
@@ -304,11 +375,68 @@ public:
     int bitSize() const {
         return 19937;
     }
+
+    /**
+     *\japanese
+     * next() を steps 回呼んだのと同じ状態に進める。
+     * @param[in] steps 進める出力の数
+     *\endjapanese
+     *
+     *\english
+     * Advances the state as if next() is called \b steps times.
+     * Large \b steps are jumped by polynomial jump-ahead.
+     * @param[in] steps number of outputs skipped
+     *\endenglish
+     */
+    void discard(uint64_t steps);
+
+    /**
+     *\japanese
+     * 2^k 個の出力を飛ばす。
+     * @param[in] k 飛ばす出力の数の log2
+     *\endjapanese
+     *
+     *\english
+     * Skips 2^k outputs by polynomial jump-ahead.
+     * @param[in] k log2 of number of outputs skipped
+     *\endenglish
+     */
+    void jumpPow2(int k);
+
+    /**
+     *\japanese
+     * 現在の状態から始まる長さ 2^k の互いに重ならない列のうち
+     * index 番目の先頭に進める。
+     * @param[in] index 列の番号
+     * @param[in] k 列の長さの log2
+     *\endjapanese
+     *
+     *\english
+     * Advances to the start of \b index -th stream of length 2^k,
+     * that is, skips index * 2^k outputs. Streams derived from
+     * the same state do not overlap.
+     * @param[in] index index of stream
+     * @param[in] k log2 of length of each stream
+     *\endenglish
+     */
+    void stream(uint64_t index, int k = 64);
 private:
     enum {N = 312, M = 156};
     uint64_t *mt;    /* the array for the state vector  */
     int mti;
-    uint64_t temper(uint64_t y) {
+    void jumpByPolynomial(const uint64_t poly[], int degree);
+    void generateBlock();
+    /*
+     * new state word from mt[i + M], mt[i] and mt[i + 1].
+     */
+    static uint64_t twist(uint64_t mid, uint64_t cur, uint64_t next) {
+        const uint64_t UPPER_MASK = UINT64_C(0xFFFFFFFF80000000);
+        const uint64_t LOWER_MASK = UINT64_C(0x000000007FFFFFFF);
+        const uint64_t MATRIX_A = UINT64_C(0xB5026F5AA96619E9);
+        uint64_t x = (cur & UPPER_MASK) | (next & LOWER_MASK);
+        return mid ^ (x >> 1) ^ ((UINT64_C(0) - (x & 1)) & MATRIX_A);
+    }
+    static uint64_t temper(uint64_t y) {
         y ^= (y >> 29) & UINT64_C(0x5555555555555555);
         y ^= (y << 17) & UINT64_C(0x71D67FFFEDA60000);
         y ^= (y << 37) & UINT64_C(0xFFF7EEE000000000);
@@ -0,0 +1,161 @@
+#pragma once
+#ifndef ONLINE_VARIANCE_H
+#define ONLINE_VARIANCE_H
+/**
+ * @file OnlineVariance.h
+ *
+ * @brief mean and variance of data given one by one.
+ *
+ * Accumulators of disjoint parts of data can be merged, so that
+ * thread local or per process accumulators are reduced to the
+ * accumulator of the whole data.
+ * OnlineCovariance is the same for vectors, and gives control variate
+ * estimates by regression on their components.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace rmcqmcint {
+    /*
+     * calculate variance
+     *
+     * See "Online algorithm" and "Parallel algorithm" at
+     * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+     */
+    class OnlineVariance {
+    public:
+        OnlineVariance();
+        void addData(const double x) {
+            n++;
+            df = n - 1;
+            double delta = x - mean;
+            mean += delta / static_cast<double>(n);
+            M2 += delta * (x - mean);
+        }
+        /**
+         * Adds all data of \b that, by the pairwise formula of
+         * Chan, Golub and LeVeque. The result does not depend on
+         * how data were split, up to rounding errors.
+         * @param that accumulator of another part of data.
+         */
+        void merge(const OnlineVariance& that);
+        /**
+         * Adds x[0], x[stride], ..., x[(size - 1) * stride].
+         * Mean and M2 of the block are calculated by pairwise summation
+         * and merged, so there is no division per data, and rounding
+         * errors grow as log of \b size.
+         * @param x data.
+         * @param size number of data.
+         * @param stride distance of adjacent data in \b x.
+         */
+        void addBlock(const double x[], size_t size, size_t stride = 1);
+        int64_t getN() const {
+            return n;
+        }
+        double getMean() const;
+        double unbiasedVar() const;
+        double var() const;
+        double absErr(const int prob) const;
+        double relErr(const int prob) const;
+    private:
+        int64_t n;
+        int64_t df;
+        double mean;
+        double M2;
+    };
+
+    /*
+     * calculate means and covariance matrix of d variables
+     *
+     * See "Covariance" of the same article as OnlineVariance.
+     */
+    class OnlineCovariance {
+    public:
+        /**
+         * Constructor
+         * @param d number of variables.
+         */
+        explicit OnlineCovariance(int d = 1);
+        /**
+         * Adds a data vector.
+         * @param x values of d variables.
+         */
+        void addData(const double x[]);
+        /**
+         * Adds all data of \b that, by the pairwise formula, the same
+         * as OnlineVariance::merge().
+         * @param that accumulator of another part of data, of the same
+         * number of variables.
+         */
+        void merge(const OnlineCovariance& that);
+        int64_t getN() const {
+            return n;
+        }
+        int getDimension() const {
+            return d;
+        }
+        double getMean(int i) const {
+            return mean[i];
+        }
+        double unbiasedCov(int i, int j) const {
+            return C[i * d + j] / static_cast<double>(n - 1);
+        }
+        /**
+         * Control variate estimate of mean of variable \b y.
+         * The last \b J variables are controls whose exact means are
+         * \b mu. Coefficients beta minimize residual variance of
+         * y - beta (c - mu), that is, solve S_cc beta = S_cy by
+         * Cholesky decomposition, where controls of too small residual
+         * variance, such as constant or collinear ones, get 0.
+         * Error is t value of n - J - 1 degrees of freedom times
+         * standard deviation of residuals over sqrt(n).
+         * @param y index of the variable, 0 <= y < d - J.
+         * @param J number of controls.
+         * @param mu exact means of controls.
+         * @param prob key of tvalue(), see probToInt().
+         * @param estimate estimated mean of \b y.
+         * @param error absolute error of the estimate, infinity when
+         * n <= J + 1.
+         */
+        void controlEstimate(int y, int J, const double mu[],
+                             const int prob, double& estimate,
+                             double& error) const;
+    private:
+        int64_t n;
+        int d;
+        std::vector<double> mean;
+        // C[i * d + j] is sum of (x_i - mean_i)(x_j - mean_j)
+        std::vector<double> C;
+    };
+
+    /**
+     * Converts probability to the key of tvalue().
+     * @param probability confidence level.
+     * @return 95, 99, 999 or 9999.
+     */
+    int probToInt(double probability);
+
+    /**
+     * t value of two sided confidence interval.
+     * @param prob 95, 99, 999 or 9999.
+     * @param df degree of freedom.
+     * @return t value.
+     */
+    double tvalue(const int prob, const int64_t df);
+}
+#endif // ONLINE_VARIANCE_H
@@ -1,5 +1,6 @@
 #include <Rcpp.h>
 #include "DigitalNet.h"
+#include <algorithm>
 
 // [[Rcpp::plugins(cpp11)]]
 
@@ -7,13 +8,32 @@ using namespace std;
 using namespace Rcpp;
 using namespace DigitalNetNS;
 
+namespace {
+    const size_t block_size = 4096;
+
+    /*
+     * 64 bit integers given as pairs of upper and lower 32 bits.
+     */
+    vector<uint64_t> toUint64(const IntegerVector& iv)
+    {
+        vector<uint64_t> x(iv.length() / 2);
+        for (size_t i = 0; i < x.size(); i++) {
+            x[i] = static_cast<uint32_t>(iv[2 * i]);
+            x[i] = (x[i] << 32) | static_cast<uint32_t>(iv[2 * i + 1]);
+        }
+        return x;
+    }
+}
+
 // [[Rcpp::export(rng = false)]]
 NumericMatrix rcppDigitalNetPoints(DataFrame df,
                                    int id,
                                    int dimR,
                                    int dimF2,
                                    uint64_t count,
-                                   NumericVector shiftVector)
+                                   NumericVector shiftVector,
+                                   uint64_t start,
+                                   int threads)
 {
     digital_net_id digitalNetId;
     if (id == 1) {
@@ -48,15 +68,97 @@ NumericMatrix rcppDigitalNetPoints(DataFrame df,
         digitalNet.setDigitalShift(shifts);
     }
     digitalNet.pointInitialize();
+    if (start > 0) {
+        digitalNet.jumpTo(start);
+    }
     //uint32_t cnt = 0;
     NumericMatrix mx(count, dimR);
     // assume that count <= 2^dimF2
-    for (size_t i = 0; i < count; i++) {
+    // R matrix is column major, points are written directly into it.
+    // Every thread writes its own rows of the matrix.
+    double * out = mx.begin();
+    if (threads < 1) {
+        threads = 1;
+    }
+    size_t chunk = block_size * threads;
+    for (size_t i = 0; i < count; i += chunk) {
         checkUserInterrupt();
+        size_t size = min(chunk, static_cast<size_t>(count - i));
+        digitalNet.fillPoints(out + i, size, COORDINATE_MAJOR, count,
+                              threads);
+    }
+    return mx;
+}
+
+/*
+ * count doubles of MersenneTwister64 of the default seed, after
+ * discard(skip) and jumpPow2(pow2), pow2 < 0 means no jump.
+ * For test of jump-ahead.
+ */
+// [[Rcpp::export(rng = false)]]
+NumericVector rcppMersenneTwister(int count, double skip, int pow2)
+{
+    MersenneTwister64 mt;
+    mt.discard(static_cast<uint64_t>(skip));
+    if (pow2 >= 0) {
+        mt.jumpPow2(pow2);
+    }
+    NumericVector x(count);
+    mt.fillDouble(x.begin(), count);
+    return x;
+}
+
+/*
+ * count points from start of each of replicates generated together by
+ * fillReplicates(), row r * count + i is i-th point of r-th replicate.
+ * shiftVector and seedVector are digital shifts and Owen scrambling
+ * seeds of replicates, dimR pairs of 32 bit integers per replicate,
+ * and empty seedVector means no scrambling. Coordinates are generated
+ * by tiles of tile coordinates, 0 means default, with kernels of
+ * simdLevel, which is restored on return. For test.
+ */
+// [[Rcpp::export(rng = false)]]
+NumericMatrix rcppReplicatePoints(DataFrame df,
+                                  int id,
+                                  int dimR,
+                                  int dimF2,
+                                  uint64_t count,
+                                  uint64_t start,
+                                  int replicates,
+                                  IntegerVector shiftVector,
+                                  IntegerVector seedVector,
+                                  int tile,
+                                  int simdLevel)
+{
+    digital_net_id digitalNetId;
+    if (id == 1) {
+        digitalNetId = NXLW;
+    } else { // id = 2
+        digitalNetId = SOLW;
+    }
+    DigitalNet<uint64_t> digitalNet(df, digitalNetId, dimR, dimF2);
+    if (tile > 0) {
+        digitalNet.setCoordinateTile(tile);
+    }
+    vector<uint64_t> shifts = toUint64(shiftVector);
+    vector<uint64_t> seeds = toUint64(seedVector);
+    if (shifts.size() != static_cast<size_t>(replicates) * dimR
+        || (!seeds.empty() && seeds.size() != shifts.size())) {
+        stop("shiftVector and seedVector need 2 * dimR * replicates"
+             " integers.");
+    }
+    vector<double> out(count * replicates * dimR);
+    int level = getSimdLevel();
+    setSimdLevel(simdLevel);
+    digitalNet.fillReplicates(start, out.data(), count, replicates,
+                              shifts.data(),
+                              seeds.empty() ? NULL : seeds.data());
+    setSimdLevel(level);
+    NumericMatrix mx(count * replicates, dimR);
+    for (size_t i = 0; i < count * replicates; i++) {
         for (int j = 0; j < dimR; j++) {
-            mx(i, j) = digitalNet.getPoint(j);
+            mx(i, j) = out[i * dimR + j];
         }
-        digitalNet.nextPoint();
     }
     return mx;
 }
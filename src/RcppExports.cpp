@@ -6,8 +6,8 @@
 using namespace Rcpp;
 
 // rcppDigitalNetPoints
-NumericMatrix rcppDigitalNetPoints(DataFrame df, int id, int dimR, int dimF2, uint64_t count, NumericVector shiftVector);
-RcppExport SEXP rmcqmcint_rcppDigitalNetPoints(SEXP dfSEXP, SEXP idSEXP, SEXP dimRSEXP, SEXP dimF2SEXP, SEXP countSEXP, SEXP shiftVectorSEXP) {
+NumericMatrix rcppDigitalNetPoints(DataFrame df, int id, int dimR, int dimF2, uint64_t count, NumericVector shiftVector, uint64_t start, int threads);
+RcppExport SEXP rmcqmcint_rcppDigitalNetPoints(SEXP dfSEXP, SEXP idSEXP, SEXP dimRSEXP, SEXP dimF2SEXP, SEXP countSEXP, SEXP shiftVectorSEXP, SEXP startSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::traits::input_parameter< DataFrame >::type df(dfSEXP);
@@ -16,45 +16,149 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type dimF2(dimF2SEXP);
     Rcpp::traits::input_parameter< uint64_t >::type count(countSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type shiftVector(shiftVectorSEXP);
-    rcpp_result_gen = Rcpp::wrap(rcppDigitalNetPoints(df, id, dimR, dimF2, count, shiftVector));
+    Rcpp::traits::input_parameter< uint64_t >::type start(startSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppDigitalNetPoints(df, id, dimR, dimF2, count, shiftVector, start, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcppMersenneTwister
+NumericVector rcppMersenneTwister(int count, double skip, int pow2);
+RcppExport SEXP rmcqmcint_rcppMersenneTwister(SEXP countSEXP, SEXP skipSEXP, SEXP pow2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type count(countSEXP);
+    Rcpp::traits::input_parameter< double >::type skip(skipSEXP);
+    Rcpp::traits::input_parameter< int >::type pow2(pow2SEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppMersenneTwister(count, skip, pow2));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcppReplicatePoints
+NumericMatrix rcppReplicatePoints(DataFrame df, int id, int dimR, int dimF2, uint64_t count, uint64_t start, int replicates, IntegerVector shiftVector, IntegerVector seedVector, int tile, int simdLevel);
+RcppExport SEXP rmcqmcint_rcppReplicatePoints(SEXP dfSEXP, SEXP idSEXP, SEXP dimRSEXP, SEXP dimF2SEXP, SEXP countSEXP, SEXP startSEXP, SEXP replicatesSEXP, SEXP shiftVectorSEXP, SEXP seedVectorSEXP, SEXP tileSEXP, SEXP simdLevelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type df(dfSEXP);
+    Rcpp::traits::input_parameter< int >::type id(idSEXP);
+    Rcpp::traits::input_parameter< int >::type dimR(dimRSEXP);
+    Rcpp::traits::input_parameter< int >::type dimF2(dimF2SEXP);
+    Rcpp::traits::input_parameter< uint64_t >::type count(countSEXP);
+    Rcpp::traits::input_parameter< uint64_t >::type start(startSEXP);
+    Rcpp::traits::input_parameter< int >::type replicates(replicatesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type shiftVector(shiftVectorSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type seedVector(seedVectorSEXP);
+    Rcpp::traits::input_parameter< int >::type tile(tileSEXP);
+    Rcpp::traits::input_parameter< int >::type simdLevel(simdLevelSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppReplicatePoints(df, id, dimR, dimF2, count, start, replicates, shiftVector, seedVector, tile, simdLevel));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcppUseFixedNets
+bool rcppUseFixedNets(bool value);
+RcppExport SEXP rmcqmcint_rcppUseFixedNets(SEXP valueSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< bool >::type value(valueSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppUseFixedNets(value));
     return rcpp_result_gen;
 END_RCPP
 }
 // rcppQMCIntegration
-List rcppQMCIntegration(Function integrand, uint32_t N, DataFrame df, int id, int s, int m, double probability);
-RcppExport SEXP rmcqmcint_rcppQMCIntegration(SEXP integrandSEXP, SEXP NSEXP, SEXP dfSEXP, SEXP idSEXP, SEXP sSEXP, SEXP mSEXP, SEXP probabilitySEXP) {
+List rcppQMCIntegration(SEXP integrand, uint32_t N, DataFrame df, int id, int s, int m, double probability, int randomization, bool vectorized, uint32_t maxBlock, int outputs, SEXP params, int mMax, double absTol, double relTol, double maxTime, int estimator, bool antithetic, NumericVector controlMeans);
+RcppExport SEXP rmcqmcint_rcppQMCIntegration(SEXP integrandSEXP, SEXP NSEXP, SEXP dfSEXP, SEXP idSEXP, SEXP sSEXP, SEXP mSEXP, SEXP probabilitySEXP, SEXP randomizationSEXP, SEXP vectorizedSEXP, SEXP maxBlockSEXP, SEXP outputsSEXP, SEXP paramsSEXP, SEXP mMaxSEXP, SEXP absTolSEXP, SEXP relTolSEXP, SEXP maxTimeSEXP, SEXP estimatorSEXP, SEXP antitheticSEXP, SEXP controlMeansSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< SEXP >::type integrand(integrandSEXP);
+    Rcpp::traits::input_parameter< uint32_t >::type N(NSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type df(dfSEXP);
+    Rcpp::traits::input_parameter< int >::type id(idSEXP);
+    Rcpp::traits::input_parameter< int >::type s(sSEXP);
+    Rcpp::traits::input_parameter< int >::type m(mSEXP);
+    Rcpp::traits::input_parameter< double >::type probability(probabilitySEXP);
+    Rcpp::traits::input_parameter< int >::type randomization(randomizationSEXP);
+    Rcpp::traits::input_parameter< bool >::type vectorized(vectorizedSEXP);
+    Rcpp::traits::input_parameter< uint32_t >::type maxBlock(maxBlockSEXP);
+    Rcpp::traits::input_parameter< int >::type outputs(outputsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type params(paramsSEXP);
+    Rcpp::traits::input_parameter< int >::type mMax(mMaxSEXP);
+    Rcpp::traits::input_parameter< double >::type absTol(absTolSEXP);
+    Rcpp::traits::input_parameter< double >::type relTol(relTolSEXP);
+    Rcpp::traits::input_parameter< double >::type maxTime(maxTimeSEXP);
+    Rcpp::traits::input_parameter< int >::type estimator(estimatorSEXP);
+    Rcpp::traits::input_parameter< bool >::type antithetic(antitheticSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type controlMeans(controlMeansSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppQMCIntegration(integrand, N, df, id, s, m, probability, randomization, vectorized, maxBlock, outputs, params, mMax, absTol, relTol, maxTime, estimator, antithetic, controlMeans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcppMLQMCIntegration
+List rcppMLQMCIntegration(SEXP integrand, uint32_t N, DataFrame df, int id, int s, int m, double probability, int randomization, bool vectorized, uint32_t maxBlock, int levels, int mMax, double absTol, double maxTime, NumericVector cost);
+RcppExport SEXP rmcqmcint_rcppMLQMCIntegration(SEXP integrandSEXP, SEXP NSEXP, SEXP dfSEXP, SEXP idSEXP, SEXP sSEXP, SEXP mSEXP, SEXP probabilitySEXP, SEXP randomizationSEXP, SEXP vectorizedSEXP, SEXP maxBlockSEXP, SEXP levelsSEXP, SEXP mMaxSEXP, SEXP absTolSEXP, SEXP maxTimeSEXP, SEXP costSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
-    Rcpp::traits::input_parameter< Function >::type integrand(integrandSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type integrand(integrandSEXP);
     Rcpp::traits::input_parameter< uint32_t >::type N(NSEXP);
     Rcpp::traits::input_parameter< DataFrame >::type df(dfSEXP);
     Rcpp::traits::input_parameter< int >::type id(idSEXP);
     Rcpp::traits::input_parameter< int >::type s(sSEXP);
     Rcpp::traits::input_parameter< int >::type m(mSEXP);
     Rcpp::traits::input_parameter< double >::type probability(probabilitySEXP);
-    rcpp_result_gen = Rcpp::wrap(rcppQMCIntegration(integrand, N, df, id, s, m, probability));
+    Rcpp::traits::input_parameter< int >::type randomization(randomizationSEXP);
+    Rcpp::traits::input_parameter< bool >::type vectorized(vectorizedSEXP);
+    Rcpp::traits::input_parameter< uint32_t >::type maxBlock(maxBlockSEXP);
+    Rcpp::traits::input_parameter< int >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< int >::type mMax(mMaxSEXP);
+    Rcpp::traits::input_parameter< double >::type absTol(absTolSEXP);
+    Rcpp::traits::input_parameter< double >::type maxTime(maxTimeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type cost(costSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppMLQMCIntegration(integrand, N, df, id, s, m, probability, randomization, vectorized, maxBlock, levels, mMax, absTol, maxTime, cost));
     return rcpp_result_gen;
 END_RCPP
 }
 // rcppMCIntegration
-List rcppMCIntegration(Function integrand, uint32_t N, int s, int m, double probability);
-RcppExport SEXP rmcqmcint_rcppMCIntegration(SEXP integrandSEXP, SEXP NSEXP, SEXP sSEXP, SEXP mSEXP, SEXP probabilitySEXP) {
+List rcppMCIntegration(SEXP integrand, uint32_t N, int s, int m, double probability, bool vectorized, uint32_t maxBlock, int outputs, int sampling, double seed, bool antithetic, NumericVector controlMeans);
+RcppExport SEXP rmcqmcint_rcppMCIntegration(SEXP integrandSEXP, SEXP NSEXP, SEXP sSEXP, SEXP mSEXP, SEXP probabilitySEXP, SEXP vectorizedSEXP, SEXP maxBlockSEXP, SEXP outputsSEXP, SEXP samplingSEXP, SEXP seedSEXP, SEXP antitheticSEXP, SEXP controlMeansSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
-    Rcpp::traits::input_parameter< Function >::type integrand(integrandSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type integrand(integrandSEXP);
     Rcpp::traits::input_parameter< uint32_t >::type N(NSEXP);
     Rcpp::traits::input_parameter< int >::type s(sSEXP);
     Rcpp::traits::input_parameter< int >::type m(mSEXP);
     Rcpp::traits::input_parameter< double >::type probability(probabilitySEXP);
-    rcpp_result_gen = Rcpp::wrap(rcppMCIntegration(integrand, N, s, m, probability));
+    Rcpp::traits::input_parameter< bool >::type vectorized(vectorizedSEXP);
+    Rcpp::traits::input_parameter< uint32_t >::type maxBlock(maxBlockSEXP);
+    Rcpp::traits::input_parameter< int >::type outputs(outputsSEXP);
+    Rcpp::traits::input_parameter< int >::type sampling(samplingSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< bool >::type antithetic(antitheticSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type controlMeans(controlMeansSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppMCIntegration(integrand, N, s, m, probability, vectorized, maxBlock, outputs, sampling, seed, antithetic, controlMeans));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rcppOnlineVariance
+NumericMatrix rcppOnlineVariance(NumericVector x, int split, int stride);
+RcppExport SEXP rmcqmcint_rcppOnlineVariance(SEXP xSEXP, SEXP splitSEXP, SEXP strideSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type split(splitSEXP);
+    Rcpp::traits::input_parameter< int >::type stride(strideSEXP);
+    rcpp_result_gen = Rcpp::wrap(rcppOnlineVariance(x, split, stride));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"rmcqmcint_rcppDigitalNetPoints", (DL_FUNC) &rmcqmcint_rcppDigitalNetPoints, 6},
-    {"rmcqmcint_rcppQMCIntegration", (DL_FUNC) &rmcqmcint_rcppQMCIntegration, 7},
-    {"rmcqmcint_rcppMCIntegration", (DL_FUNC) &rmcqmcint_rcppMCIntegration, 5},
+    {"rmcqmcint_rcppDigitalNetPoints", (DL_FUNC) &rmcqmcint_rcppDigitalNetPoints, 8},
+    {"rmcqmcint_rcppMersenneTwister", (DL_FUNC) &rmcqmcint_rcppMersenneTwister, 3},
+    {"rmcqmcint_rcppReplicatePoints", (DL_FUNC) &rmcqmcint_rcppReplicatePoints, 11},
+    {"rmcqmcint_rcppUseFixedNets", (DL_FUNC) &rmcqmcint_rcppUseFixedNets, 1},
+    {"rmcqmcint_rcppQMCIntegration", (DL_FUNC) &rmcqmcint_rcppQMCIntegration, 19},
+    {"rmcqmcint_rcppMLQMCIntegration", (DL_FUNC) &rmcqmcint_rcppMLQMCIntegration, 15},
+    {"rmcqmcint_rcppMCIntegration", (DL_FUNC) &rmcqmcint_rcppMCIntegration, 12},
+    {"rmcqmcint_rcppOnlineVariance", (DL_FUNC) &rmcqmcint_rcppOnlineVariance, 3},
     {NULL, NULL, 0}
 };
 
@@ -1,58 +1,293 @@
 #include <Rcpp.h>
-#include <random>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 #include <time.h>
 #include "DigitalNet.h"
+#include "FixedDigitalNet.h"
+#include "Integrand.h"
+#include "OnlineVariance.h"
+#include "WalshEstimator.h"
+#include "Sampler.h"
 
 // [[Rcpp::plugins(cpp11)]]
 
 using namespace std;
 using namespace Rcpp;
 using namespace DigitalNetNS;
+using rmcqmcint::Integrand;
+using rmcqmcint::OnlineVariance;
+using rmcqmcint::OnlineCovariance;
+using rmcqmcint::probToInt;
+using rmcqmcint::fastWalshTransform;
+using rmcqmcint::walshErrorBound;
+using rmcqmcint::Sampler;
 
 //#define DEBUG 1
 
 namespace {
+    // upper limit of doubles in a block, for large s
+    const uint64_t block_doubles = UINT64_C(1) << 20;
+    // number of replicates generated together by fillReplicates
+    const uint32_t replicate_batch = 64;
+    // the same, when stopping rule is checked after each batch
+    const uint32_t adaptive_batch = 8;
+    // upper limit of integrand values stored by estimator walsh, 2 GB
+    const uint64_t walsh_doubles = UINT64_C(1) << 28;
+
+    uint64_t blockSize(uint64_t max, int s, uint64_t limit);
+
+    // randomization of replicates, the same as qmcint()
+    enum randomization_id {
+        DIGITAL_SHIFT = 1,
+        OWEN_SCRAMBLE = 2,
+        LINEAR_SCRAMBLE = 3
+    };
+
+    // error estimator of qmcint()
+    enum estimator_id {
+        REPLICATE_ESTIMATOR = 1,
+        WALSH_ESTIMATOR = 2,
+        MEDIAN_ESTIMATOR = 3,
+        INTERNAL_ESTIMATOR = 4
+    };
+
     /*
-     * calculate variance
-     *
-     * See "Online algorithm" at
-     * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
+     * Estimate of integrals from means of replicates.
+     * REPLICATE_ESTIMATOR and INTERNAL_ESTIMATOR give mean of the
+     * replicate means and its t based error. MEDIAN_ESTIMATOR gives
+     * median of them and half width of distribution free confidence
+     * interval of median, which is infinite when there are too few
+     * replicates for the probability.
+     * With controls, replicates have K + J outputs, whose last J are
+     * control variates of known means, and the estimate of each of
+     * the first K outputs is the control variate estimate by
+     * regression on the replicate means, see
+     * OnlineCovariance::controlEstimate().
      */
-    class OnlineVariance {
+    class ReplicateEstimate {
     public:
-        OnlineVariance();
-        void addData(const double x) {
-            n++;
-            df = n - 1;
-            double delta = x - mean;
-            mean += delta / static_cast<double>(n);
-            M2 += delta * (x - mean);
-        }
-        double getMean() const;
-        double unbiasedVar() const;
-        double var() const;
-        double absErr(const int prob) const;
-        double relErr(const int prob) const;
+        ReplicateEstimate(int K, int estimator, double probability,
+                          const vector<double>& controls = vector<double>())
+            : K(K), estimator(estimator), probability(probability),
+              p(probToInt(probability)), eachintval(K), controls(controls),
+              cov(K + static_cast<int>(controls.size())) {
+        }
+        /*
+         * adds a replicate, intsum[k] is its k-th output.
+         */
+        void addReplicate(const OnlineVariance intsum[]) {
+            for (int k = 0; k < K; ++k) {
+                eachintval[k].addData(intsum[k].getMean());
+                means.push_back(intsum[k].getMean());
+            }
+            if (!controls.empty()) {
+                vector<double> x(cov.getDimension());
+                for (size_t k = 0; k < x.size(); ++k) {
+                    x[k] = intsum[k].getMean();
+                }
+                cov.addData(x.data());
+            }
+        }
+        uint32_t getReplicates() const {
+            return static_cast<uint32_t>(eachintval[0].getN());
+        }
+        void estimate(vector<double>& mean, vector<double>& error) const;
+    private:
+        void medianEstimate(int k, double& median, double& error) const;
+        int K;
+        int estimator;
+        double probability;
+        int p;
+        vector<OnlineVariance> eachintval;
+        // means[r * K + k] is k-th output of r-th replicate
+        vector<double> means;
+        // known means of controls
+        vector<double> controls;
+        // replicate means of outputs and controls
+        OnlineCovariance cov;
+    };
+
+    /*
+     * Stopping rule of adaptive integration, integration stops when
+     * absolute error of every output is not greater than absTol or
+     * relTol times absolute value of its mean, or when maxTime seconds
+     * have passed from start. Not adaptive when both tolerances are 0
+     * and maxTime is infinite.
+     */
+    class StoppingRule {
+    public:
+        StoppingRule(double absTol, double relTol, double maxTime)
+            : absTol(absTol), relTol(relTol), maxTime(maxTime),
+              start(chrono::steady_clock::now()) {
+        }
+        bool isAdaptive() const {
+            return absTol > 0 || relTol > 0 || std::isfinite(maxTime);
+        }
+        bool isConverged(const vector<double>& mean,
+                         const vector<double>& error) const;
+        bool isTimeOver() const {
+            chrono::duration<double> elapsed
+                = chrono::steady_clock::now() - start;
+            return elapsed.count() >= maxTime;
+        }
+        bool shouldStop(const ReplicateEstimate& est) const {
+            if (!isAdaptive()) {
+                return false;
+            }
+            vector<double> mean;
+            vector<double> error;
+            est.estimate(mean, error);
+            return isConverged(mean, error) || isTimeOver();
+        }
     private:
-        int n;
-        int df;
-        double mean;
-        double M2;
+        bool isWithin(double mean, double error) const {
+            return error <= max(absTol, relTol * fabs(mean));
+        }
+        double absTol;
+        double relTol;
+        double maxTime;
+        chrono::steady_clock::time_point start;
+    };
+
+    template<typename Net>
+    void qmcIntegration(Net& digitalNet, Integrand& integrand,
+                        uint32_t N, int s, int m, int randomization,
+                        uint64_t maxBlock, const StoppingRule& rule,
+                        ReplicateEstimate& est,
+                        const MersenneTwister64 * generator = NULL);
+
+    const uint64_t * randomizeNet(DigitalNet<uint64_t>& digitalNet,
+                                  int randomization, vector<uint64_t>& shift,
+                                  vector<uint64_t>& seeds);
+
+    void walshIntegration(DigitalNet<uint64_t>& digitalNet,
+                          Integrand& integrand, int s, int m,
+                          int randomization, uint64_t maxBlock,
+                          vector<double>& mean, vector<double>& error);
+
+    void internalIntegration(DigitalNet<uint64_t>& digitalNet,
+                             Integrand& integrand, int s, int m,
+                             int randomization, uint64_t maxBlock,
+                             uint32_t subNets, ReplicateEstimate& est);
+
+    void replicateIntegration(DigitalNet<uint64_t>& digitalNet,
+                              Integrand& integrand, uint32_t N, int s,
+                              int m, int randomization, uint64_t maxBlock,
+                              const StoppingRule& rule,
+                              ReplicateEstimate& est,
+                              const MersenneTwister64 * generator = NULL);
+
+    void levelIntegration(SEXP integrand, int level, DataFrame df,
+                          digital_net_id digitalNetId, int s, int m,
+                          uint32_t N, double probability, int randomization,
+                          bool vectorized, uint64_t maxBlock,
+                          const MersenneTwister64& generator,
+                          double& mean, double& error);
+
+    DataFrame netOfDimF2(DataFrame df, int m);
+
+    /*
+     * QMC integration with FixedDigitalNet<uint64_t, S, M>
+     */
+    template<uint32_t S, uint32_t M>
+    void fixedQMCIntegration(const DigitalNet<uint64_t>& digitalNet,
+                             Integrand& integrand, uint32_t N,
+                             int randomization, uint64_t maxBlock,
+                             const StoppingRule& rule,
+                             ReplicateEstimate& est,
+                             const MersenneTwister64 * generator)
+    {
+        FixedDigitalNet<uint64_t, S, M> fixedNet(digitalNet);
+        qmcIntegration(fixedNet, integrand, N, S, M, randomization,
+                       maxBlock, rule, est, generator);
+    }
+
+    typedef void (*fixed_qmc_t)(const DigitalNet<uint64_t>& digitalNet,
+                                Integrand& integrand, uint32_t N,
+                                int randomization, uint64_t maxBlock,
+                                const StoppingRule& rule,
+                                ReplicateEstimate& est,
+                                const MersenneTwister64 * generator);
+
+    struct fixed_qmc_entry {
+        int s;
+        int m;
+        fixed_qmc_t integration;
+    };
+
+    /*
+     * (s, m) integrated with FixedDigitalNet, frequently used ones.
+     */
+    const fixed_qmc_entry fixed_qmc_table[] = {
+        {4, 10, fixedQMCIntegration<4, 10>},
+        {4, 12, fixedQMCIntegration<4, 12>},
+        {4, 14, fixedQMCIntegration<4, 14>},
+        {4, 16, fixedQMCIntegration<4, 16>},
+        {5, 10, fixedQMCIntegration<5, 10>},
+        {5, 12, fixedQMCIntegration<5, 12>},
+        {5, 14, fixedQMCIntegration<5, 14>},
+        {5, 16, fixedQMCIntegration<5, 16>},
+        {6, 10, fixedQMCIntegration<6, 10>},
+        {6, 12, fixedQMCIntegration<6, 12>},
+        {6, 14, fixedQMCIntegration<6, 14>},
+        {6, 16, fixedQMCIntegration<6, 16>},
+        {8, 10, fixedQMCIntegration<8, 10>},
+        {8, 12, fixedQMCIntegration<8, 12>},
+        {8, 14, fixedQMCIntegration<8, 14>},
+        {8, 16, fixedQMCIntegration<8, 16>},
+        {10, 10, fixedQMCIntegration<10, 10>},
+        {10, 12, fixedQMCIntegration<10, 12>},
+        {10, 14, fixedQMCIntegration<10, 14>},
+        {10, 16, fixedQMCIntegration<10, 16>},
+        {12, 12, fixedQMCIntegration<12, 12>},
+        {12, 14, fixedQMCIntegration<12, 14>},
+        {16, 12, fixedQMCIntegration<16, 12>},
+        {16, 14, fixedQMCIntegration<16, 14>}
     };
 
-    int probToInt(double probability);
-    double tvalue(const int prob, const int df);
+    const size_t fixed_qmc_table_size
+    = sizeof(fixed_qmc_table) / sizeof(fixed_qmc_entry);
 
+    /*
+     * false when fixed_qmc_table is not used, for test.
+     */
+    bool use_fixed_nets = true;
+}
+
+/*
+ * Turns integration with FixedDigitalNet for (s, m) in
+ * fixed_qmc_table on or off, and returns the previous setting.
+ * Both give the same results. For test.
+ */
+// [[Rcpp::export(rng = false)]]
+bool rcppUseFixedNets(bool value)
+{
+    bool previous = use_fixed_nets;
+    use_fixed_nets = value;
+    return previous;
 }
 
 // [[Rcpp::export(rng = false)]]
-List rcppQMCIntegration(Function integrand,
+List rcppQMCIntegration(SEXP integrand,
                         uint32_t N,
                         DataFrame df,
                         int id,
                         int s,
                         int m,
-                        double probability)
+                        double probability,
+                        int randomization,
+                        bool vectorized,
+                        uint32_t maxBlock,
+                        int outputs,
+                        SEXP params,
+                        int mMax,
+                        double absTol,
+                        double relTol,
+                        double maxTime,
+                        int estimator,
+                        bool antithetic,
+                        NumericVector controlMeans)
 {
 #if defined(DEBUG)
     cout << "N:" << dec << N << endl;
@@ -67,45 +302,199 @@ List rcppQMCIntegration(Function integrand,
     } else { // id == 2
         digitalNetId = SOLW;
     }
-    DigitalNet<uint64_t> digitalNet(df, digitalNetId, s, m);
-    digitalNet.pointInitialize();
-    OnlineVariance eachintval;
-    uint32_t cnt = 0;
-    int p = probToInt(probability);
-    NumericVector nv(s);
-    do {
-        checkUserInterrupt();
-        OnlineVariance intsum;
-        uint64_t max = 1;
-        max = max << m;
-        for (uint64_t j = 0; j < max; ++j) {
-            for (int k = 0; k < s; ++k) {
-                nv[k] = digitalNet.getPoint(k);
+    StoppingRule rule(absTol, relTol, maxTime);
+    Integrand f(integrand, s, vectorized, outputs, params);
+    f.setAntithetic(antithetic);
+    vector<double> controls(controlMeans.begin(), controlMeans.end());
+    // outputs of integrand are K outputs followed by controls
+    int K = f.getOutputs() - static_cast<int>(controls.size());
+    if (K < 1) {
+        stop("integrand should return more values than controlMeans.");
+    }
+    if (!controls.empty()
+        && (estimator == WALSH_ESTIMATOR || estimator == MEDIAN_ESTIMATOR)) {
+        stop("controlMeans needs estimator replicate or internal.");
+    }
+    if (estimator == WALSH_ESTIMATOR && randomization == OWEN_SCRAMBLE) {
+        stop("estimator walsh needs randomization shift or linear.");
+    }
+    // each point is evaluated twice when antithetic
+    double pointCost = antithetic ? 2.0 : 1.0;
+    // adaptive integration restarts with 2^(m + 1) points when N
+    // replicates of 2^m points, or the estimate by one net of 2^m
+    // points, do not meet the tolerance. Nets of different m are not
+    // nested, so points of smaller m are not reused.
+    double evaluations = 0;
+    for (;;) {
+        DigitalNet<uint64_t> digitalNet(netOfDimF2(df, m), digitalNetId,
+                                        s, m);
+        vector<double> mean(K);
+        vector<double> error(K);
+        uint32_t replicates = 1;
+        if (estimator == WALSH_ESTIMATOR) {
+            walshIntegration(digitalNet, f, s, m, randomization, maxBlock,
+                             mean, error);
+            evaluations += ldexp(pointCost, m);
+        } else if (estimator == INTERNAL_ESTIMATOR) {
+            ReplicateEstimate est(K, estimator, probability, controls);
+            internalIntegration(digitalNet, f, s, m, randomization,
+                                maxBlock, N, est);
+            evaluations += ldexp(pointCost, m);
+            replicates = est.getReplicates();
+            est.estimate(mean, error);
+        } else {
+            ReplicateEstimate est(K, estimator, probability, controls);
+            replicateIntegration(digitalNet, f, N, s, m, randomization,
+                                 maxBlock, rule, est);
+            replicates = est.getReplicates();
+            evaluations += ldexp(pointCost * replicates, m);
+            est.estimate(mean, error);
+        }
+        bool converged = rule.isConverged(mean, error);
+        if (!rule.isAdaptive() || converged || rule.isTimeOver()
+            || m >= mMax) {
+            LogicalVector conv = LogicalVector::create(converged);
+            if (!rule.isAdaptive()) {
+                conv[0] = NA_LOGICAL;
             }
-            double d = as<double>(integrand(nv));
-#if defined(DEBUG)
-            //cout << "o:" << o << endl;
-            cout << "d:" << d << endl;
-#endif
-            intsum.addData(d);
-            digitalNet.nextPoint();
+            return List::create(Named("mean")=wrap(mean),
+                                Named("absError")=wrap(error),
+                                Named("evaluations")=evaluations,
+                                Named("m")=m,
+                                Named("replicates")=replicates,
+                                Named("converged")=conv);
         }
-        eachintval.addData(intsum.getMean());
-        digitalNet.setDigitalShift(true);
-        digitalNet.pointInitialize();
-        cnt++;
-    } while ( cnt < N );
-    List data = List::create(Named("mean")=eachintval.getMean(),
-                             Named("absError")=eachintval.absErr(p));
-    return data;
+        m++;
+    }
+}
+
+// [[Rcpp::export(rng = false)]]
+List rcppMLQMCIntegration(SEXP integrand,
+                          uint32_t N,
+                          DataFrame df,
+                          int id,
+                          int s,
+                          int m,
+                          double probability,
+                          int randomization,
+                          bool vectorized,
+                          uint32_t maxBlock,
+                          int levels,
+                          int mMax,
+                          double absTol,
+                          double maxTime,
+                          NumericVector cost)
+{
+    digital_net_id digitalNetId;
+    if (id == 1) {
+        digitalNetId = NXLW;
+    } else { // id == 2
+        digitalNetId = SOLW;
+    }
+    StoppingRule rule(absTol, 0, maxTime);
+    IntegerVector level(levels);
+    IntegerVector levelM(levels);
+    NumericVector levelMean(levels);
+    NumericVector levelError(levels);
+    NumericVector evaluations(levels);
+    NumericVector levelCost(levels);
+    NumericVector seconds(levels);
+    // stream l + 1 of random numbers for level l, jumped once here
+    // and copied on each refinement, since a jump of 2^64 is slow.
+    vector<MersenneTwister64> streams(levels);
+    for (int l = 0; l < levels; l++) {
+        level[l] = l;
+        if (l > 0) {
+            streams[l] = streams[l - 1];
+        }
+        streams[l].jumpPow2(64);
+    }
+    // Each level starts with 2^m points. Then the level of the largest
+    // error^2 / (cost of its next refinement) is refined with twice
+    // as many points, until root sum of squares of errors of levels is
+    // not greater than absTol, as Giles and Waterhouse. Levels use
+    // independent streams of random numbers, so their errors are
+    // combined as independent ones. Nets of different m are not
+    // nested, so a refined level is integrated again.
+    int refine = 0;
+    bool converged = false;
+    for (int l = 0; ; ) {
+        if (refine < levels) {
+            l = refine++;
+            levelM[l] = m;
+        } else {
+            vector<double> mean(1, 0.0);
+            vector<double> error(1, 0.0);
+            for (int i = 0; i < levels; i++) {
+                mean[0] += levelMean[i];
+                error[0] += levelError[i] * levelError[i];
+            }
+            error[0] = sqrt(error[0]);
+            converged = rule.isConverged(mean, error);
+            if (converged || rule.isTimeOver()) {
+                break;
+            }
+            l = -1;
+            double best = 0;
+            for (int i = 0; i < levels; i++) {
+                double gain = levelError[i] * levelError[i]
+                    / (ldexp(cost[i], levelM[i]));
+                if (levelM[i] < mMax && (l < 0 || gain > best)) {
+                    l = i;
+                    best = gain;
+                }
+            }
+            if (l < 0) {
+                break;
+            }
+            levelM[l]++;
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        levelIntegration(integrand, l, netOfDimF2(df, levelM[l]),
+                         digitalNetId, s, levelM[l], N, probability,
+                         randomization, vectorized, maxBlock, streams[l],
+                         levelMean[l], levelError[l]);
+        chrono::duration<double> elapsed
+            = chrono::steady_clock::now() - start;
+        evaluations[l] += ldexp(static_cast<double>(N), levelM[l]);
+        levelCost[l] = evaluations[l] * cost[l];
+        seconds[l] += elapsed.count();
+    }
+    double mean = 0;
+    double error = 0;
+    double total = 0;
+    for (int i = 0; i < levels; i++) {
+        mean += levelMean[i];
+        error += levelError[i] * levelError[i];
+        total += evaluations[i];
+    }
+    DataFrame levelData = DataFrame::create(Named("level")=level,
+                                            Named("m")=levelM,
+                                            Named("mean")=levelMean,
+                                            Named("absError")=levelError,
+                                            Named("evaluations")=evaluations,
+                                            Named("cost")=levelCost,
+                                            Named("seconds")=seconds);
+    return List::create(Named("mean")=mean,
+                        Named("absError")=sqrt(error),
+                        Named("evaluations")=total,
+                        Named("converged")=converged,
+                        Named("levels")=levelData);
 }
 
 // [[Rcpp::export(rng = false)]]
-List rcppMCIntegration(Function integrand,
+List rcppMCIntegration(SEXP integrand,
                        uint32_t N,
                        int s,
                        int m,
-                       double probability)
+                       double probability,
+                       bool vectorized,
+                       uint32_t maxBlock,
+                       int outputs,
+                       int sampling,
+                       double seed,
+                       bool antithetic,
+                       NumericVector controlMeans)
 {
 #if defined(DEBUG)
     cout << "N:" << dec << N << endl;
@@ -113,542 +502,478 @@ List rcppMCIntegration(Function integrand,
     cout << "m:" << dec << m << endl;
     cout << "probability:" << probability << endl;
 #endif
-    uint64_t seed = static_cast<uint32_t>(clock());
-    mt19937_64 rand(seed);
-    uniform_real_distribution<double> dist(0.0, 1.0);
-    OnlineVariance eachintval;
+    // negative seed means seed from clock
+    uint64_t seed64 = static_cast<uint32_t>(clock());
+    if (seed >= 0) {
+        seed64 = static_cast<uint64_t>(seed);
+    }
     uint32_t cnt = 0;
-    int p = probToInt(probability);
-    NumericVector nv(s);
+    Integrand f(integrand, s, vectorized, outputs);
+    f.setAntithetic(antithetic);
+    vector<double> controls(controlMeans.begin(), controlMeans.end());
+    // all outputs including controls
+    int K = f.getOutputs();
+    int outK = K - static_cast<int>(controls.size());
+    if (outK < 1) {
+        stop("integrand should return more values than controlMeans.");
+    }
+    ReplicateEstimate est(outK, REPLICATE_ESTIMATOR, probability, controls);
+    uint64_t max = 1;
+    max = max << m;
+    size_t block = static_cast<size_t>(blockSize(max, s, maxBlock));
+    vector<double> points(block * s);
+    vector<double> values(block * K);
+    Sampler sampler(sampling, s, m, seed64);
     do {
         checkUserInterrupt();
-        OnlineVariance intsum;
-        uint64_t max = 1;
-        max = max << m;
-        for (uint64_t j = 0; j < max; ++j) {
-            for (int k = 0; k < s; ++k) {
-                nv[k] = dist(rand);
+        sampler.startReplicate();
+        vector<OnlineVariance> intsum(K);
+        for (uint64_t j = 0; j < max; j += block) {
+            sampler.fill(j, points.data(), block);
+            f.evaluate(points.data(), block, values.data());
+            for (int k = 0; k < K; ++k) {
+                intsum[k].addBlock(&values[k], block, K);
             }
-            double d = as<double>(integrand(nv));
-#if defined(DEBUG)
-            //cout << "o:" << o << endl;
-            cout << "d:" << d << endl;
-#endif
-            intsum.addData(d);
         }
-        eachintval.addData(intsum.getMean());
+        est.addReplicate(intsum.data());
         cnt++;
     } while ( cnt < N );
-    List data = List::create(Named("mean")=eachintval.getMean(),
-                             Named("absError")=eachintval.absErr(p));
-    return data;
+    vector<double> mean;
+    vector<double> error;
+    est.estimate(mean, error);
+    return List::create(Named("mean")=wrap(mean),
+                        Named("absError")=wrap(error));
+}
+
+/*
+ * n, mean and unbiased variance of data x[0], x[stride], x[2 * stride],
+ * ..., rows are those by addData() one by one, by merge() of
+ * accumulators of the first split data and the rest added one by one,
+ * by addBlock() of all data, and by merge() of addBlock() of the two
+ * parts. For test.
+ */
+// [[Rcpp::export(rng = false)]]
+NumericMatrix rcppOnlineVariance(NumericVector x, int split, int stride)
+{
+    size_t size = (x.length() + stride - 1) / stride;
+    size_t head = min(static_cast<size_t>(split), size);
+    OnlineVariance sequential;
+    OnlineVariance first;
+    OnlineVariance second;
+    for (size_t i = 0; i < size; i++) {
+        sequential.addData(x[i * stride]);
+        if (i < head) {
+            first.addData(x[i * stride]);
+        } else {
+            second.addData(x[i * stride]);
+        }
+    }
+    first.merge(second);
+    OnlineVariance block;
+    block.addBlock(x.begin(), size, stride);
+    OnlineVariance blocks;
+    blocks.addBlock(x.begin(), head, stride);
+    if (head < size) {
+        blocks.addBlock(x.begin() + head * stride, size - head, stride);
+    }
+    const OnlineVariance * acc[] = {&sequential, &first, &block, &blocks};
+    NumericMatrix result(4, 3);
+    for (int i = 0; i < 4; i++) {
+        result(i, 0) = static_cast<double>(acc[i]->getN());
+        result(i, 1) = acc[i]->getMean();
+        result(i, 2) = acc[i]->unbiasedVar();
+    }
+    return result;
 }
 
 namespace {
-    int probToInt(double probability)
+    /*
+     * Integration by N randomized replicates of the digital net.
+     * By DIGITAL_SHIFT, the first replicate is not shifted, and by
+     * OWEN_SCRAMBLE, all replicates are scrambled without digital shift.
+     * By LINEAR_SCRAMBLE, base of each replicate is linearly scrambled
+     * and digitally shifted.
+     * Net is DigitalNet or FixedDigitalNet. Up to replicate_batch
+     * replicates are generated together in one gray code walk, except
+     * for LINEAR_SCRAMBLE, whose replicates have different bases.
+     * When generator is not NULL, random numbers are drawn from its
+     * state, e.g. one of non-overlapping streams, and the first
+     * replicate is also shifted, for estimates independent of those of
+     * other streams.
+     */
+    template<typename Net>
+    void qmcIntegration(Net& digitalNet, Integrand& integrand,
+                        uint32_t N, int s, int m, int randomization,
+                        uint64_t maxBlock, const StoppingRule& rule,
+                        ReplicateEstimate& est,
+                        const MersenneTwister64 * generator)
     {
-        double x = 1.0 - probability;
-        if (x < 0.00011) {
-            return 9999;
-        } else if (x < 0.0011) {
-            return 999;
-        } else if (x < 0.011) {
-            return 99;
-        } else {
-            return 95;
+        int K = integrand.getOutputs();
+        uint64_t max = 1;
+        max = max << m;
+        size_t block = static_cast<size_t>(blockSize(max, s, maxBlock));
+        uint32_t batch = min(N, replicate_batch);
+        if (rule.isAdaptive()) {
+            batch = min(batch, adaptive_batch);
+        }
+        while (batch > 1 && block * s * batch > block_doubles) {
+            batch = batch / 2;
         }
+        vector<uint64_t> original;
+        if (randomization == LINEAR_SCRAMBLE) {
+            batch = 1;
+            original.resize(s * m);
+            digitalNet.saveBase(original.data(), original.size());
+        }
+        vector<double> points(block * s * batch);
+        vector<double> values(block * K);
+        vector<uint64_t> shifts(s * batch);
+        vector<uint64_t> seeds;
+        const uint64_t * seed = NULL;
+        if (randomization == OWEN_SCRAMBLE) {
+            seeds.resize(s * batch);
+            seed = seeds.data();
+        }
+        if (generator != NULL) {
+            digitalNet.setShiftGenerator(*generator);
+        }
+        uint32_t cnt = 0;
+        do {
+            checkUserInterrupt();
+            uint32_t rep = min(batch, N - cnt);
+            // the same shifts as walking replicates one by one, where
+            // nextPoint() at the end of a shifted replicate draws
+            // a shift, which is not used.
+            for (uint32_t r = 0; r < rep; r++) {
+                if (randomization == LINEAR_SCRAMBLE) {
+                    digitalNet.restoreBase(original.data(), original.size());
+                    digitalNet.scramble();
+                    digitalNet.drawDigitalShift(&shifts[r * s]);
+                    continue;
+                }
+                if (randomization == OWEN_SCRAMBLE) {
+                    fill(&shifts[r * s], &shifts[r * s] + s, 0);
+                    digitalNet.drawDigitalShift(&seeds[r * s]);
+                    continue;
+                }
+                if (generator != NULL) {
+                    digitalNet.drawDigitalShift(&shifts[r * s]);
+                    continue;
+                }
+                if (cnt + r == 0) {
+                    fill(shifts.begin(), shifts.begin() + s, 0);
+                    continue;
+                }
+                if (cnt + r >= 2) {
+                    digitalNet.drawDigitalShift(&shifts[r * s]);
+                }
+                digitalNet.drawDigitalShift(&shifts[r * s]);
+            }
+            // intsum[r * K + k] is k-th output of r-th replicate
+            vector<OnlineVariance> intsum(rep * K);
+            for (uint64_t j = 0; j < max; j += block) {
+                digitalNet.fillReplicates(j, points.data(), block, rep,
+                                          shifts.data(), seed);
+                for (uint32_t r = 0; r < rep; r++) {
+                    integrand.evaluate(&points[r * block * s], block,
+                                       values.data());
+                    for (int k = 0; k < K; ++k) {
+                        intsum[r * K + k].addBlock(&values[k], block, K);
+                    }
+                }
+            }
+            for (uint32_t r = 0; r < rep; r++) {
+                est.addReplicate(&intsum[r * K]);
+            }
+            cnt += rep;
+        } while ( cnt < N && !rule.shouldStop(est) );
     }
 
+    void ReplicateEstimate::estimate(vector<double>& mean,
+                                     vector<double>& error) const
+    {
+        mean.resize(K);
+        error.resize(K);
+        for (int k = 0; k < K; ++k) {
+            if (estimator == MEDIAN_ESTIMATOR) {
+                medianEstimate(k, mean[k], error[k]);
+            } else if (!controls.empty()) {
+                cov.controlEstimate(k, static_cast<int>(controls.size()),
+                                    controls.data(), p, mean[k], error[k]);
+            } else {
+                mean[k] = eachintval[k].getMean();
+                error[k] = eachintval[k].absErr(p);
+            }
+        }
+    }
 
     /*
-     * calculate variance
-     *
-     * See "Online algorithm" at
-     * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
+     * [x(j), x(n - j + 1)] of sorted replicate means covers median of
+     * their distribution with probability 1 - 2 P(B <= j - 1), where B
+     * is binomial of n trials with 1/2. j is the largest one with
+     * coverage not less than probability.
      */
-    OnlineVariance::OnlineVariance()
+    void ReplicateEstimate::medianEstimate(int k, double& median,
+                                           double& error) const
     {
-        n = 0;
-        df = n - 1;
-        mean = 0.0;
-        M2 = 0.0;
+        size_t n = static_cast<size_t>(getReplicates());
+        vector<double> x(n);
+        for (size_t r = 0; r < n; r++) {
+            x[r] = means[r * K + k];
+        }
+        sort(x.begin(), x.end());
+        if (n % 2 == 1) {
+            median = x[n / 2];
+        } else {
+            median = (x[n / 2 - 1] + x[n / 2]) * 0.5;
+        }
+        double alpha = (1.0 - probability) / 2.0;
+        double logn = lgamma(static_cast<double>(n) + 1.0);
+        double cdf = 0;
+        size_t j = 0;
+        for (size_t i = 0; i < n / 2; i++) {
+            double di = static_cast<double>(i);
+            cdf += exp(logn - lgamma(di + 1.0)
+                       - lgamma(static_cast<double>(n) - di + 1.0)
+                       - static_cast<double>(n) * log(2.0));
+            if (cdf > alpha) {
+                break;
+            }
+            j = i + 1;
+        }
+        if (j == 0) {
+            error = INFINITY;
+            return;
+        }
+        error = max(median - x[j - 1], x[n - j] - median);
     }
 
-    double OnlineVariance::getMean() const
+    bool StoppingRule::isConverged(const vector<double>& mean,
+                                   const vector<double>& error) const
     {
-        return mean;
+        if (absTol <= 0 && relTol <= 0) {
+            return false;
+        }
+        for (size_t k = 0; k < mean.size(); k++) {
+            if (!isWithin(mean[k], error[k])) {
+                return false;
+            }
+        }
+        return true;
     }
 
-    double OnlineVariance::unbiasedVar() const
+    /*
+     * Integration by N replicates, with FixedDigitalNet when (s, m) is
+     * in fixed_qmc_table, unless turned off by rcppUseFixedNets().
+     */
+    void replicateIntegration(DigitalNet<uint64_t>& digitalNet,
+                              Integrand& integrand, uint32_t N, int s,
+                              int m, int randomization, uint64_t maxBlock,
+                              const StoppingRule& rule,
+                              ReplicateEstimate& est,
+                              const MersenneTwister64 * generator)
     {
-        return M2 / static_cast<double>(df);
+        for (size_t i = 0; use_fixed_nets && i < fixed_qmc_table_size; i++) {
+            if (fixed_qmc_table[i].s == s && fixed_qmc_table[i].m == m) {
+                fixed_qmc_table[i].integration(digitalNet, integrand, N,
+                                               randomization, maxBlock,
+                                               rule, est, generator);
+                return;
+            }
+        }
+        qmcIntegration(digitalNet, integrand, N, s, m, randomization,
+                       maxBlock, rule, est, generator);
     }
 
-    double OnlineVariance::var() const
+    /*
+     * Integration of level l of multilevel integrand by N replicates
+     * of the digital net of F2 dimension m in df. Integrand is called
+     * with parameter l, as qmcsweep() with one row of parameters.
+     * Random numbers are drawn from generator, the state of stream
+     * l + 1 made once per level, so that estimates of levels are
+     * independent.
+     */
+    void levelIntegration(SEXP integrand, int level, DataFrame df,
+                          digital_net_id digitalNetId, int s, int m,
+                          uint32_t N, double probability, int randomization,
+                          bool vectorized, uint64_t maxBlock,
+                          const MersenneTwister64& generator,
+                          double& mean, double& error)
     {
-        if ( n == 1 ) {
-            return 0.0;
+        NumericMatrix params(1, 1);
+        params(0, 0) = level;
+        Integrand f(integrand, s, vectorized, 1, params);
+        DigitalNet<uint64_t> digitalNet(df, digitalNetId, s, m);
+        StoppingRule rule(0, 0, INFINITY);
+        ReplicateEstimate est(1, REPLICATE_ESTIMATOR, probability);
+        replicateIntegration(digitalNet, f, N, s, m, randomization,
+                             maxBlock, rule, est, &generator);
+        vector<double> means;
+        vector<double> errors;
+        est.estimate(means, errors);
+        mean = means[0];
+        error = errors[0];
+    }
+
+    /*
+     * Randomizes digitalNet for integration by one replicate, whose
+     * shift and Owen scrambling seeds are returned in shift and seeds.
+     * By DIGITAL_SHIFT, the replicate is shifted.
+     * @return seeds for fillReplicates.
+     */
+    const uint64_t * randomizeNet(DigitalNet<uint64_t>& digitalNet,
+                                  int randomization, vector<uint64_t>& shift,
+                                  vector<uint64_t>& seeds)
+    {
+        int s = digitalNet.getS();
+        shift.assign(s, 0);
+        if (randomization == LINEAR_SCRAMBLE) {
+            digitalNet.scramble();
         }
-        return (1.0 -  1.0 / static_cast<double>(n)) * unbiasedVar();
+        if (randomization == OWEN_SCRAMBLE) {
+            seeds.resize(s);
+            digitalNet.drawDigitalShift(seeds.data());
+            return seeds.data();
+        }
+        digitalNet.drawDigitalShift(shift.data());
+        return NULL;
     }
 
-    double OnlineVariance::absErr(const int prob) const
+    /*
+     * Integration by one randomized replicate of the digital net,
+     * whose error is bounded by Walsh coefficients of integrand values.
+     * Randomization should be linear, DIGITAL_SHIFT or LINEAR_SCRAMBLE,
+     * so that the transform by digital index gives Walsh coefficients
+     * of the randomized net, which OWEN_SCRAMBLE does not.
+     */
+    void walshIntegration(DigitalNet<uint64_t>& digitalNet,
+                          Integrand& integrand, int s, int m,
+                          int randomization, uint64_t maxBlock,
+                          vector<double>& mean, vector<double>& error)
     {
-        return tvalue(prob, df) * sqrt(unbiasedVar() / static_cast<double>(n));
+        int K = integrand.getOutputs();
+        uint64_t max = 1;
+        max = max << m;
+        if (max > walsh_doubles / K) {
+            stop("estimator walsh stores 2^m * outputs values, which is"
+                 " more than 2^28, use smaller m or estimator replicate.");
+        }
+        size_t block = static_cast<size_t>(blockSize(max, s, maxBlock));
+        vector<double> points(block * s);
+        vector<double> values(block * K);
+        vector<uint64_t> shift;
+        vector<uint64_t> seeds;
+        const uint64_t * seed = randomizeNet(digitalNet, randomization,
+                                             shift, seeds);
+        // y[k * max + g] is k-th output at the point of digital index g
+        vector<double> y(max * K);
+        for (uint64_t j = 0; j < max; j += block) {
+            checkUserInterrupt();
+            digitalNet.fillReplicates(j, points.data(), block, 1,
+                                      shift.data(), seed);
+            integrand.evaluate(points.data(), block, values.data());
+            for (size_t i = 0; i < block; ++i) {
+                uint64_t g = (j + i) ^ ((j + i) >> 1);
+                for (int k = 0; k < K; ++k) {
+                    y[k * max + g] = values[i * K + k];
+                }
+            }
+        }
+        mean.resize(K);
+        error.resize(K);
+        for (int k = 0; k < K; ++k) {
+            fastWalshTransform(&y[k * max], m);
+            mean[k] = y[k * max];
+            error[k] = walshErrorBound(&y[k * max], m);
+        }
     }
 
-    double OnlineVariance::relErr(const int prob) const
+    /*
+     * Integration by one randomized replicate of the digital net,
+     * split into subNets sub-nets, whose means are regarded as
+     * replicates. Points in a gray code walk of length 2^m / subNets
+     * = 2^(m - k) from its multiple are a coset of the subspace
+     * spanned by the first m - k rows of base.
+     * subNets is rounded down to a power of two, 2 <= subNets <= 2^m.
+     */
+    void internalIntegration(DigitalNet<uint64_t>& digitalNet,
+                             Integrand& integrand, int s, int m,
+                             int randomization, uint64_t maxBlock,
+                             uint32_t subNets, ReplicateEstimate& est)
     {
-        return absErr(prob) / mean;
+        int K = integrand.getOutputs();
+        uint64_t max = 1;
+        max = max << m;
+        uint64_t nets = 2;
+        while (nets * 2 <= subNets && nets < max) {
+            nets = nets * 2;
+        }
+        uint64_t size = max / nets;
+        size_t block = static_cast<size_t>(blockSize(size, s,
+                                                     min(maxBlock, size)));
+        vector<double> points(block * s);
+        vector<double> values(block * K);
+        vector<uint64_t> shift;
+        vector<uint64_t> seeds;
+        const uint64_t * seed = randomizeNet(digitalNet, randomization,
+                                             shift, seeds);
+        for (uint64_t c = 0; c < nets; c++) {
+            checkUserInterrupt();
+            vector<OnlineVariance> intsum(K);
+            for (uint64_t j = c * size; j < (c + 1) * size; j += block) {
+                digitalNet.fillReplicates(j, points.data(), block, 1,
+                                          shift.data(), seed);
+                integrand.evaluate(points.data(), block, values.data());
+                for (int k = 0; k < K; ++k) {
+                    intsum[k].addBlock(&values[k], block, K);
+                }
+            }
+            est.addReplicate(intsum.data());
+        }
     }
 
-    const double tval95[100] = {
-        INFINITY,
-        12.70620473617471,
-        4.302652729749464,
-        3.182446305283709,
-        2.776445105197794,
-        2.570581835636316,
-        2.446911851144969,
-        2.364624251592784,
-        2.306004135204168,
-        2.262157162798205,
-        2.228138851986274,
-        2.200985160091639,
-        2.178812829667228,
-        2.160368656462791,
-        2.144786687917803,
-        2.131449545559774,
-        2.119905299221253,
-        2.109815577833314,
-        2.100922040241038,
-        2.09302405440831,
-        2.085963447265865,
-        2.079613844727679,
-        2.073873067904025,
-        2.068657610419046,
-        2.063898561628024,
-        2.059538552753296,
-        2.055529438642873,
-        2.051830516480284,
-        2.048407141795245,
-        2.045229642132703,
-        2.042272456301236,
-        2.039513446396406,
-        2.036933343460098,
-        2.034515297449337,
-        2.032244509317717,
-        2.03010792825034,
-        2.028094000980448,
-        2.026192463029105,
-        2.024394163911966,
-        2.02269092003676,
-        2.021075390306271,
-        2.019540970441374,
-        2.018081702818442,
-        2.016692199227822,
-        2.01536757444376,
-        2.014103388880843,
-        2.012895598919425,
-        2.011740513729767,
-        2.010634757624229,
-        2.009575237129233,
-        2.008559112100758,
-        2.007583770315835,
-        2.006646805061686,
-        2.005745995317864,
-        2.004879288188052,
-        2.004044783289136,
-        2.003240718847872,
-        2.002465459291013,
-        2.001717484145232,
-        2.000995378088259,
-        2.000297822014258,
-        1.999623584994937,
-        1.99897151703338,
-        1.998340542520748,
-        1.997729654317688,
-        1.997137908391998,
-        1.996564418952312,
-        1.9960083540253,
-        1.995468931429831,
-        1.994945415107228,
-        1.994437111771185,
-        1.993943367845623,
-        1.993463566661876,
-        1.992997125889848,
-        1.99254349518093,
-        1.992102154002228,
-        1.991672609644675,
-        1.991254395388376,
-        1.990847068811688,
-        1.990450210230115,
-        1.990063421254447,
-        1.98968632345689,
-        1.989318557136571,
-        1.988959780175168,
-        1.98860966697571,
-        1.988267907477211,
-        1.987934206239023,
-        1.987608281589075,
-        1.987289864831162,
-        1.98697869950627,
-        1.986674540703772,
-        1.98637715441862,
-        1.986086316951114,
-        1.985801814345816,
-        1.985523441866611,
-        1.985251003505502,
-        1.984984311522451,
-        1.984723186013967,
-        1.984467454508484,
-        1.984216951586394
-    };
-    const double tval99[100] = {
-        INFINITY,
-        63.65674116287158,
-        9.92484320091829,
-        5.840909309733357,
-        4.604094871349994,
-        4.032142983555229,
-        3.707428021324779,
-        3.499483297350493,
-        3.355387331333395,
-        3.249835541592125,
-        3.169272672616958,
-        3.105806515539281,
-        3.054539589392901,
-        3.012275838716581,
-        2.976842734370837,
-        2.946712883475236,
-        2.9207816224251,
-        2.89823051967741,
-        2.878440472738607,
-        2.860934606464975,
-        2.84533970978611,
-        2.831359558023051,
-        2.818756060600139,
-        2.80733568377,
-        2.796939504774456,
-        2.787435813676966,
-        2.778714533329683,
-        2.770682957122215,
-        2.76326245546145,
-        2.756385903670604,
-        2.749995653567222,
-        2.744041919294267,
-        2.738481482012186,
-        2.733276642350837,
-        2.728394367070722,
-        2.723805589208087,
-        2.719484630450008,
-        2.715408721549987,
-        2.711557601913079,
-        2.707913183517662,
-        2.704459267433159,
-        2.701181303578525,
-        2.698066186219984,
-        2.695102079157675,
-        2.692278265693025,
-        2.689585019374642,
-        2.687013492242213,
-        2.684555617866529,
-        2.682204026950213,
-        2.679951973631546,
-        2.677793270940843,
-        2.675722234110649,
-        2.673733630647216,
-        2.671822636240999,
-        2.669984795734891,
-        2.668215988486186,
-        2.666512397556062,
-        2.664870482241977,
-        2.663286953537656,
-        2.661758752162956,
-        2.660283028855036,
-        2.658857126653925,
-        2.657478564951159,
-        2.656145025099861,
-        2.654854337411088,
-        2.653604469382921,
-        2.652393515028315,
-        2.651219685183664,
-        2.650081298694729,
-        2.648976774388622,
-        2.647904623751154,
-        2.646863444238384,
-        2.645851913159326,
-        2.644868782073378,
-        2.64391287165309,
-        2.642983066967388,
-        2.642078313146006,
-        2.641197611389271,
-        2.640340015292127,
-        2.639504627453213,
-        2.638690596344182,
-        2.63789711341577,
-        2.637123410420375,
-        2.636368756932125,
-        2.635632458047966,
-        2.634913852254293,
-        2.634212309445641,
-        2.633527229082502,
-        2.632858038477643,
-        2.632204191200006,
-        2.631565165587168,
-        2.63094046335777,
-        2.630329608316278,
-        2.629732145142834,
-        2.629147638261708,
-        2.628575670782746,
-        2.628015843510056,
-        2.627467774013243,
-        2.626931095756376,
-        2.626405457280807
-    };
-    const double tval999[100] = {
-        INFINITY,
-        636.6192487687195,
-        31.59905457644384,
-        12.92397863668748,
-        8.61030158137928,
-        6.868826625881111,
-        5.958816178818759,
-        5.407882520861724,
-        5.041305433373368,
-        4.780912585931139,
-        4.586893858702645,
-        4.436979338234478,
-        4.317791283606168,
-        4.220831727707082,
-        4.14045411273823,
-        4.072765195903752,
-        4.014996327184011,
-        3.965126272119054,
-        3.92164582508522,
-        3.883405852592038,
-        3.849516274930783,
-        3.819277164274519,
-        3.792130671698386,
-        3.767626804311771,
-        3.745398619290085,
-        3.725143949728602,
-        3.706611743480885,
-        3.68959171345926,
-        3.673906400701251,
-        3.659405019466324,
-        3.64595863504204,
-        3.633456349758311,
-        3.621802259867474,
-        3.610913007654441,
-        3.600715797386407,
-        3.59114677581078,
-        3.582149701456308,
-        3.573674844445201,
-        3.565678071580218,
-        3.558120081332715,
-        3.550965760863278,
-        3.54418364297154,
-        3.53774544532746,
-        3.531625677808036,
-        3.525801306487192,
-        3.520251464971102,
-        3.5149572054818,
-        3.509901283449472,
-        3.505067970470219,
-        3.50044289136738,
-        3.496012881811146,
-        3.491765863533892,
-        3.487690734657202,
-        3.483777273038441,
-        3.480016050870256,
-        3.476398359033575,
-        3.472916139929921,
-        3.469561927704801,
-        3.466328794931011,
-        3.46321030495197,
-        3.460200469196346,
-        3.457293708870371,
-        3.454484820512028,
-        3.451768944961039,
-        3.449141539356402,
-        3.446598351821966,
-        3.444135398543995,
-        3.441748942981201,
-        3.439435476979527,
-        3.437191703591056,
-        3.43501452142082,
-        3.432901010344113,
-        3.43084841845811,
-        3.428854150143901,
-        3.426915755130341,
-        3.425030918463961,
-        3.423197451297198,
-        3.42141328241927,
-        3.419676450460553,
-        3.417985096707856,
-        3.416337458476955,
-        3.414731862991554,
-        3.41316672172466,
-        3.41164052516158,
-        3.410151837948819,
-        3.408699294396417,
-        3.407281594302747,
-        3.405897499076685,
-        3.40454582813179,
-        3.403225455530765,
-        3.401935306860252,
-        3.400674356317186,
-        3.399441623991326,
-        3.39823617332754,
-        3.397057108754526,
-        3.395903573468006,
-        3.394774747355655,
-        3.393669845054,
-        3.392588114128191,
-        3.391528833363675
-    };
-    const double tval9999[100] = {
-        INFINITY,
-        6366.197671315937,
-        99.9924998437626,
-        28.00013001094897,
-        15.54410058154568,
-        11.17771007027861,
-        9.08234632729399,
-        7.884584262416603,
-        7.120003882734538,
-        6.593682583944785,
-        6.211050891290663,
-        5.921194162473098,
-        5.694465793270489,
-        5.51251504959594,
-        5.36341304115686,
-        5.239088211753351,
-        5.133893517546163,
-        5.043764976637879,
-        4.965706285291434,
-        4.897461588862503,
-        4.837301152910126,
-        4.78387711643666,
-        4.736124060964879,
-        4.693189001074219,
-        4.654381146882377,
-        4.619135234934404,
-        4.586984347628043,
-        4.557539482371515,
-        4.530473997385761,
-        4.505511631211056,
-        4.48241717540962,
-        4.460989140783963,
-        4.441053938116005,
-        4.422461221367341,
-        4.405080131644159,
-        4.388796245353427,
-        4.373509077449665,
-        4.359130025631424,
-        4.345580667374725,
-        4.332791341212695,
-        4.320699958497129,
-        4.309251003158447,
-        4.298394685708726,
-        4.288086224457699,
-        4.278285232207232,
-        4.268955190813545,
-        4.260062999285661,
-        4.251578583711409,
-        4.243474559354365,
-        4.235725936988641,
-        4.22830986684588,
-        4.221205414689356,
-        4.214393365408906,
-        4.207856050271693,
-        4.201577194576874,
-        4.195541782955869,
-        4.189735939982705,
-        4.184146824100817,
-        4.178762533171716,
-        4.173572020183271,
-        4.168565017864455,
-        4.163731971136108,
-        4.159063976455232,
-        4.154552727250363,
-        4.150190464752762,
-        4.145969933594872,
-        4.141884341665224,
-        4.137927323737989,
-        4.134092908475612,
-        4.130375488441361,
-        4.126769792813175,
-        4.123270862510752,
-        4.119874027497455,
-        4.116574886036276,
-        4.113369285702419,
-        4.110253305989199,
-        4.107223242347968,
-        4.104275591528019,
-        4.101407038092006,
-        4.098614442002582,
-        4.09589482718146,
-        4.093245370948945,
-        4.090663394268818,
-        4.088146352735075,
-        4.085691828217225,
-        4.083297521129293,
-        4.080961243255047,
-        4.078680911091212,
-        4.076454539657677,
-        4.074280236743662,
-        4.072156197557194,
-        4.070080699731753,
-        4.068052098675123,
-        4.06606882323561,
-        4.064129371642391,
-        4.062232307723325,
-        4.060376257359947,
-        4.058559905177522,
-        4.056781991433366,
-        4.055041309114493
-    };
+    /*
+     * digital net of F2 dimension m in df, which has rows of
+     * several dimf2. df without dimf2 column, Sobol base, is
+     * the same for all m.
+     */
+    DataFrame netOfDimF2(DataFrame df, int m)
+    {
+        if (!df.containsElementNamed("dimf2")) {
+            return df;
+        }
+        NumericVector dimf2 = df["dimf2"];
+        NumericVector wafom = df["wafom"];
+        NumericVector tvalue = df["tvalue"];
+        StringVector data = df["data"];
+        for (int i = 0; i < dimf2.length(); i++) {
+            if (dimf2[i] == m) {
+                return DataFrame::create(
+                    Named("dimf2")=NumericVector::create(dimf2[i]),
+                    Named("wafom")=NumericVector::create(wafom[i]),
+                    Named("tvalue")=NumericVector::create(tvalue[i]),
+                    Named("data")=StringVector::create(data[i]),
+                    Named("stringsAsFactors")=false);
+            }
+        }
+        stop("digital net of the F2 dimension is not found.");
+        return df;
+    }
 
-// prob = 95 or 99 or 999 or 9999
-// df is degree of freedom. df = n - 1.
-    double tvalue(const int prob, const int df)
+    /*
+     * number of points in a block, the largest power of two not
+     * greater than max, which is also a power of two, and limit.
+     */
+    uint64_t blockSize(uint64_t max, int s, uint64_t limit)
     {
-        if ( df < 0 ) {
-            string message = "Error in tvalue()\n";
-            message += "df must be >= 0, but now, df = ";
-            message += df;
-            //throw invalid_argument(message.c_str());
-            Rcpp::stop(message);
-        }
-        const double * array;
-        switch ( prob ) {
-        case 95:
-            array = tval95;
-            break;
-        case 99:
-            array = tval99;
-            break;
-        case 999:
-            array = tval999;
-            break;
-        case 9999:
-            array = tval9999;
-            break;
-        default:
-            string message = "Error in tvalue()\n";
-            message += "prob = ";
-            message += prob;
-            message += " is not supported.";
-            //throw invalid_argument(message.c_str());
-            Rcpp::stop(message);
-        }
-
-        if (df <= 99) {
-            return array[df];
-        } else {
-            return array[99];
+        uint64_t block = 1;
+        while (block < max && block * 2 <= limit) {
+            block = block * 2;
         }
+        while (block > 1 && block * s > block_doubles) {
+            block = block / 2;
+        }
+        return block;
     }
 }
+
@@ -0,0 +1,80 @@
+/**
+ * @file Sampler.cpp
+ *
+ * @brief random points of Monte-Carlo integration.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "Sampler.h"
+
+// [[Rcpp::plugins(cpp11)]]
+
+using namespace std;
+
+namespace rmcqmcint {
+
+    Sampler::Sampler(int sampling, int s, int m, uint64_t seed)
+        : sampling(sampling), s(s), m(m), mt(seed), seeds(s), bits(s)
+    {
+        // m bits of point index are split among coordinates, the first
+        // m % s coordinates have one more bit.
+        for (int j = 0; j < s; j++) {
+            bits[j] = m / s + (j < m % s ? 1 : 0);
+        }
+    }
+
+    void Sampler::startReplicate()
+    {
+        if (sampling == LATIN_HYPERCUBE) {
+            for (int j = 0; j < s; j++) {
+                seeds[j] = mt.getUint32();
+            }
+        }
+    }
+
+    void Sampler::fill(uint64_t first, double out[], size_t count)
+    {
+        if (sampling == PLAIN_MC) {
+            mt.fillDouble(out, count * s);
+            return;
+        }
+        // x = (cell + u) / 2^b, by putting 53 - b bits of u below b
+        // bits of cell, so that x < 1 exactly.
+        raw.resize(count * s);
+        mt.fill(raw.data(), count * s);
+        const double scale = 1.0 / 9007199254740992.0;
+        if (sampling == LATIN_HYPERCUBE) {
+            uint32_t mask = static_cast<uint32_t>((UINT64_C(1) << m) - 1);
+            for (size_t i = 0; i < count; i++) {
+                uint32_t index = static_cast<uint32_t>(first + i);
+                for (int j = 0; j < s; j++) {
+                    uint64_t cell = permute(index, mask, seeds[j]);
+                    uint64_t x = (cell << (53 - m))
+                        | (raw[i * s + j] >> (11 + m));
+                    out[i * s + j] = static_cast<double>(x) * scale;
+                }
+            }
+        } else {
+            // cell of point i is given by bits of i, one point a cell
+            for (size_t i = 0; i < count; i++) {
+                uint64_t index = first + i;
+                for (int j = 0; j < s; j++) {
+                    uint64_t cell = index & ((UINT64_C(1) << bits[j]) - 1);
+                    index >>= bits[j];
+                    uint64_t x = (cell << (53 - bits[j]))
+                        | (raw[i * s + j] >> (11 + bits[j]));
+                    out[i * s + j] = static_cast<double>(x) * scale;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef SAMPLER_H
+#define SAMPLER_H
+/**
+ * @file Sampler.h
+ *
+ * @brief random points of Monte-Carlo integration.
+ *
+ * A replicate of 2^m points is plain Monte-Carlo samples, a Latin
+ * hypercube sample or a jittered stratified sample, and is generated
+ * block by block without storing the whole replicate.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "MersenneTwister64.h"
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace rmcqmcint {
+
+    // sampling plan of mcint()
+    enum sampling_id {
+        PLAIN_MC = 1,
+        LATIN_HYPERCUBE = 2,
+        STRATIFIED = 3
+    };
+
+    /**
+     * Random permutation of [0, 2^m) indexed by \b seed, the hash of
+     * A. Kensler, "Correlated Multi-Jittered Sampling", 2013.
+     * @param i index, i < 2^m.
+     * @param mask 2^m - 1, m <= 32.
+     * @param seed seed of the permutation.
+     * @return i-th element of the permutation.
+     */
+    inline uint32_t permute(uint32_t i, uint32_t mask, uint32_t seed) {
+        i ^= seed;
+        i *= UINT32_C(0xe170893d);
+        i ^= seed >> 16;
+        i ^= (i & mask) >> 4;
+        i ^= seed >> 8;
+        i *= UINT32_C(0x0929eb3f);
+        i ^= seed >> 23;
+        i ^= (i & mask) >> 1;
+        i *= 1 | seed >> 27;
+        i *= UINT32_C(0x6935fa69);
+        i ^= (i & mask) >> 11;
+        i *= UINT32_C(0x74dcb303);
+        i ^= (i & mask) >> 2;
+        i *= UINT32_C(0x9e501cc3);
+        i ^= (i & mask) >> 2;
+        i *= UINT32_C(0xc860a3df);
+        i &= mask;
+        i ^= i >> 5;
+        return (i + seed) & mask;
+    }
+
+    class Sampler {
+    public:
+        /**
+         * Constructor
+         * @param sampling one of sampling_id.
+         * @param s dimension.
+         * @param m replicate has 2^m points, m <= 32 unless PLAIN_MC.
+         * @param seed seed of random number generator.
+         */
+        Sampler(int sampling, int s, int m, uint64_t seed);
+
+        /**
+         * Starts a new replicate, draws permutations of Latin hypercube.
+         */
+        void startReplicate();
+
+        /**
+         * Writes points first, ..., first + count - 1 of the current
+         * replicate, i-th point is out[i * s], ..., out[i * s + s - 1].
+         * Points of a replicate should be written once each, in order.
+         * @param first index of the first point.
+         * @param out buffer of count * s doubles.
+         * @param count number of points.
+         */
+        void fill(uint64_t first, double out[], size_t count);
+    private:
+        int sampling;
+        int s;
+        int m;
+        MersenneTwister64 mt;
+        // seeds of permutations of coordinates for LATIN_HYPERCUBE
+        std::vector<uint32_t> seeds;
+        // number of bits of cell index of each coordinate for STRATIFIED
+        std::vector<int> bits;
+        std::vector<uint64_t> raw;
+    };
+}
+#endif // SAMPLER_H
@@ -0,0 +1,69 @@
+/**
+ * @file WalshEstimator.cpp
+ *
+ * @brief error bound of QMC integration by Walsh coefficients.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "WalshEstimator.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// [[Rcpp::plugins(cpp11)]]
+
+using namespace std;
+
+namespace rmcqmcint {
+    void fastWalshTransform(double y[], int m)
+    {
+        size_t n = static_cast<size_t>(1) << m;
+        for (size_t h = 1; h < n; h *= 2) {
+            for (size_t i = 0; i < n; i += 2 * h) {
+                for (size_t j = i; j < i + h; j++) {
+                    double even = y[j];
+                    double odd = y[j + h];
+                    y[j] = (even + odd) * 0.5;
+                    y[j + h] = (even - odd) * 0.5;
+                }
+            }
+        }
+    }
+
+    double walshErrorBound(const double y[], int m)
+    {
+        size_t n = static_cast<size_t>(1) << m;
+        // map[kappa] is the index of kappa-th coefficient, larger one
+        // of kappa and kappa + 2^l goes to the lower frequency.
+        vector<size_t> map(n);
+        for (size_t i = 0; i < n; i++) {
+            map[i] = i;
+        }
+        for (int l = m - 1; l >= 1; l--) {
+            size_t nl = static_cast<size_t>(1) << l;
+            for (size_t j = 1; j < nl; j++) {
+                if (fabs(y[map[nl + j]]) <= fabs(y[map[j]])) {
+                    continue;
+                }
+                for (size_t b = 0; b < n; b += 2 * nl) {
+                    swap(map[b + j], map[b + nl + j]);
+                }
+            }
+        }
+        size_t start = static_cast<size_t>(1) << (m - walsh_lag - 1);
+        double sum = 0;
+        for (size_t kappa = start; kappa < 2 * start; kappa++) {
+            sum += fabs(y[map[kappa]]);
+        }
+        return ldexp(walsh_fudge, -static_cast<int>(m)) * sum;
+    }
+}
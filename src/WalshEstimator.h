@@ -0,0 +1,59 @@
+#pragma once
+#ifndef WALSH_ESTIMATOR_H
+#define WALSH_ESTIMATOR_H
+/**
+ * @file WalshEstimator.h
+ *
+ * @brief error bound of QMC integration by a single digital net.
+ *
+ * Integrand values at 2^m points of a digitally shifted or scrambled
+ * digital net, ordered by digital index, are transformed by fast
+ * Walsh-Hadamard transform. Error of the mean is bounded by the sum of
+ * absolute values of Walsh coefficients of a lower frequency band,
+ * assuming that the coefficients decay steadily, as in cubSobol_g of
+ * GAIL by Hickernell and Jimenez Rugama.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include <stdint.h>
+#include <cstddef>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace rmcqmcint {
+    // lag of frequency band used for the bound, r of cubSobol_g
+    const int walsh_lag = 4;
+    // inflation factor of the bound, multiplied by 2^-m as the fudge
+    // factor 5 * 2^-m of cubSobol_g
+    const double walsh_fudge = 5.0;
+
+    /**
+     * Fast Walsh-Hadamard transform in place, normalized so that
+     * y[0] becomes the mean of \b y.
+     * @param y 2^m values, y[k] is the value at the point of digital
+     * index k, gray code index of the point is k ^ (k >> 1).
+     * @param m log2 of number of values.
+     */
+    void fastWalshTransform(double y[], int m);
+
+    /**
+     * Error bound of the mean of 2^m values.
+     * Walsh coefficients are reordered by their absolute values level
+     * by level, and the sum of absolute values of the coefficients in
+     * [2^(m - r - 1), 2^(m - r)) is inflated by walsh_fudge * 2^-m.
+     * @param y Walsh coefficients by fastWalshTransform.
+     * @param m log2 of number of coefficients, m > walsh_lag.
+     * @return error bound.
+     */
+    double walshErrorBound(const double y[], int m);
+}
+#endif // WALSH_ESTIMATOR_H
@@ -165,4 +165,91 @@ static inline int tailingZeroBit(uint64_t x)
     return(ones((x & -x) - 1));
 }
 
+/**
+ * Transposes 64 x 64 bit matrix in place.
+ * After the call, bit i of a[j] is bit j of a[i] before the call.
+ *
+ * citing from Hacker's Delight, 7-3 Transposing a Bit Matrix.
+ * @param[in,out] a 64 x 64 bit matrix
+ */
+static inline void transpose64(uint64_t a[64])
+{
+    uint64_t mask = UINT64_C(0x00000000ffffffff);
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+            a[k | j] ^= t;
+            a[k] ^= t << j;
+        }
+    }
+}
+
+/**
+ * Transposes 32 x 32 bit matrix in place, the same as transpose64().
+ * @param[in,out] a 32 x 32 bit matrix
+ */
+static inline void transpose32(uint32_t a[32])
+{
+    uint32_t mask = UINT32_C(0x0000ffff);
+    for (int j = 16; j != 0; j >>= 1, mask ^= mask << j) {
+        for (int k = 0; k < 32; k = ((k | j) + 1) & ~j) {
+            uint32_t t = ((a[k] >> j) ^ a[k | j]) & mask;
+            a[k | j] ^= t;
+            a[k] ^= t << j;
+        }
+    }
+}
+
+static inline void transpose(uint64_t a[64])
+{
+    transpose64(a);
+}
+
+static inline void transpose(uint32_t a[32])
+{
+    transpose32(a);
+}
+
+/**
+ * 64 linear combinations of rows over F2, bit sliced.
+ *
+ * out[t] is XOR of rows[r] for all r < size such that bit t of
+ * select[r] is 1. Bit b of all out[t] is computed at once as a
+ * 64-bit word, then the words are transposed.
+ * @param[out] out 64 linear combinations
+ * @param[in] rows rows to be combined
+ * @param[in] size number of rows
+ * @param[in] select select[r] tells which out[t] contains rows[r]
+ */
+static inline void linearCombination64(uint64_t out[64],
+                                       const uint64_t rows[], int size,
+                                       const uint64_t select[])
+{
+    for (int b = 0; b < 64; b++) {
+        uint64_t slice = 0;
+        for (int r = 0; r < size; r++) {
+            slice ^= select[r] & -((rows[r] >> b) & 1);
+        }
+        out[b] = slice;
+    }
+    transpose64(out);
+}
+
+/**
+ * 64 linear combinations of rows over F2.
+ * 32-bit version of linearCombination64, not bit sliced.
+ */
+static inline void linearCombination64(uint32_t out[64],
+                                       const uint32_t rows[], int size,
+                                       const uint64_t select[])
+{
+    for (int t = 0; t < 64; t++) {
+        uint32_t x = 0;
+        for (int r = 0; r < size; r++) {
+            x ^= rows[r] & -static_cast<uint32_t>((select[r] >> t) & 1);
+        }
+        out[t] = x;
+    }
+}
+
 #endif // BIT_OPERATOR_H
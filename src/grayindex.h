@@ -32,6 +32,13 @@ public:
     void next() {
         count++;
     }
+    /*
+     * index() after this call returns the bit changed at the
+     * value-th step.
+     */
+    void set(uint64_t value) {
+        count = value;
+    }
     int index() {
         return tailingZeroBit(count);
     }
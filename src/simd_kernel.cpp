@@ -0,0 +1,438 @@
+/**
+ * @file simd_kernel.cpp
+ *
+ * @brief inner loops of DigitalNet point generation.
+ *
+ * Kernels for AVX2 and AVX-512 are compiled with target attribute,
+ * so that the package itself can be compiled with default flags.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "simd_kernel.h"
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(_M_X64)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// [[Rcpp::plugins(cpp11)]]
+
+using namespace std;
+
+/*
+ * Unnamed NameSpace for file scope things.
+ */
+namespace {
+    using namespace DigitalNetNS;
+
+    typedef void (*xor_array_t)(uint64_t dst[], const uint64_t src[],
+                                size_t size);
+    typedef void (*convert_array_t)(double out[], const uint64_t x[],
+                                    const uint64_t shift[], size_t size);
+    typedef void (*owen_convert_array_t)(double out[], const uint64_t x[],
+                                         const uint64_t shift[],
+                                         const uint64_t seed[], size_t size);
+
+    void xor_array_generic(uint64_t dst[], const uint64_t src[], size_t size)
+    {
+        for (size_t i = 0; i < size; i++) {
+            dst[i] ^= src[i];
+        }
+    }
+
+    void convert_array_generic(double out[], const uint64_t x[],
+                               const uint64_t shift[], size_t size)
+    {
+        for (size_t i = 0; i < size; i++) {
+            out[i] = toDouble(x[i] ^ shift[i]);
+        }
+    }
+
+    void owen_convert_array_generic(double out[], const uint64_t x[],
+                                    const uint64_t shift[],
+                                    const uint64_t seed[], size_t size)
+    {
+        for (size_t i = 0; i < size; i++) {
+            out[i] = toDouble(owenScramble(x[i] ^ shift[i], seed[i]));
+        }
+    }
+
+#if defined(HAVE_X86_SIMD)
+    // SSE2 is always available on x86_64
+    void xor_array_sse2(uint64_t dst[], const uint64_t src[], size_t size)
+    {
+        size_t i = 0;
+        for (; i + 2 <= size; i += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(a, b));
+        }
+        for (; i < size; i++) {
+            dst[i] ^= src[i];
+        }
+    }
+
+    void convert_array_sse2(double out[], const uint64_t x[],
+                            const uint64_t shift[], size_t size)
+    {
+        const __m128i one = _mm_set1_epi64x(mantissa_one);
+        const __m128d offset = _mm_set1_pd(mantissa_offset);
+        size_t i = 0;
+        for (; i + 2 <= size; i += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(x + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(shift + i));
+            a = _mm_or_si128(_mm_srli_epi64(_mm_xor_si128(a, b), 12), one);
+            _mm_storeu_pd(out + i, _mm_sub_pd(_mm_castsi128_pd(a), offset));
+        }
+        for (; i < size; i++) {
+            out[i] = toDouble(x[i] ^ shift[i]);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void xor_array_avx2(uint64_t dst[], const uint64_t src[], size_t size)
+    {
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(src + i));
+            _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(a, b));
+        }
+        for (; i < size; i++) {
+            dst[i] ^= src[i];
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void convert_array_avx2(double out[], const uint64_t x[],
+                            const uint64_t shift[], size_t size)
+    {
+        const __m256i one = _mm256_set1_epi64x(mantissa_one);
+        const __m256d offset = _mm256_set1_pd(mantissa_offset);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(x + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(shift + i));
+            a = _mm256_or_si256(_mm256_srli_epi64(_mm256_xor_si256(a, b), 12),
+                                one);
+            _mm256_storeu_pd(out + i,
+                             _mm256_sub_pd(_mm256_castsi256_pd(a), offset));
+        }
+        for (; i < size; i++) {
+            out[i] = toDouble(x[i] ^ shift[i]);
+        }
+    }
+
+    /*
+     * swaps bits of mask and bits k above them, a step of reverseBit()
+     */
+    __attribute__((target("avx2")))
+    inline __m256i swap_bits_avx2(__m256i x, uint64_t mask, int k)
+    {
+        const __m256i mk = _mm256_set1_epi64x(mask);
+        return _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi64(x, k), mk),
+                               _mm256_slli_epi64(_mm256_and_si256(x, mk), k));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i reverse_bit_avx2(__m256i x)
+    {
+        x = swap_bits_avx2(x, UINT64_C(0x5555555555555555), 1);
+        x = swap_bits_avx2(x, UINT64_C(0x3333333333333333), 2);
+        x = swap_bits_avx2(x, UINT64_C(0x0f0f0f0f0f0f0f0f), 4);
+        x = swap_bits_avx2(x, UINT64_C(0x00ff00ff00ff00ff), 8);
+        x = swap_bits_avx2(x, UINT64_C(0x0000ffff0000ffff), 16);
+        return _mm256_shuffle_epi32(x, 0xb1);
+    }
+
+    /*
+     * lower 64 bits of a * b, AVX2 has no 64-bit multiplication.
+     */
+    __attribute__((target("avx2")))
+    inline __m256i mullo_avx2(__m256i a, __m256i b)
+    {
+        __m256i lo = _mm256_mul_epu32(a, b);
+        __m256i hi = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+            _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    }
+
+    /*
+     * the same as owenScramble()
+     */
+    __attribute__((target("avx2")))
+    inline __m256i owen_scramble_avx2(__m256i x, __m256i seed)
+    {
+        const __m256i c1 = _mm256_set1_epi64x(owen_mul1);
+        const __m256i c2 = _mm256_set1_epi64x(owen_mul2);
+        const __m256i c3 = _mm256_set1_epi64x(owen_mul3);
+        const __m256i one = _mm256_set1_epi64x(1);
+        x = reverse_bit_avx2(x);
+        x = _mm256_xor_si256(x, mullo_avx2(x, c1));
+        x = _mm256_add_epi64(x, seed);
+        x = mullo_avx2(x, _mm256_or_si256(_mm256_srli_epi64(seed, 32), one));
+        x = _mm256_xor_si256(x, mullo_avx2(x, c2));
+        x = _mm256_xor_si256(x, mullo_avx2(x, c3));
+        return reverse_bit_avx2(x);
+    }
+
+    __attribute__((target("avx2")))
+    void owen_convert_array_avx2(double out[], const uint64_t x[],
+                                 const uint64_t shift[],
+                                 const uint64_t seed[], size_t size)
+    {
+        const __m256i one = _mm256_set1_epi64x(mantissa_one);
+        const __m256d offset = _mm256_set1_pd(mantissa_offset);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(x + i));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(shift + i));
+            __m256i c = _mm256_loadu_si256((const __m256i *)(seed + i));
+            a = owen_scramble_avx2(_mm256_xor_si256(a, b), c);
+            a = _mm256_or_si256(_mm256_srli_epi64(a, 12), one);
+            _mm256_storeu_pd(out + i,
+                             _mm256_sub_pd(_mm256_castsi256_pd(a), offset));
+        }
+        for (; i < size; i++) {
+            out[i] = toDouble(owenScramble(x[i] ^ shift[i], seed[i]));
+        }
+    }
+
+    /*
+     * Shifts, rotation and multiplication below are zero masked with
+     * all lanes selected. Their unmasked intrinsics of GCC 12 merge
+     * into an undefined vector, of which no lane is used, but
+     * -Wmaybe-uninitialized reports it after inlining.
+     */
+    const __mmask8 all_lanes = 0xff;
+
+    __attribute__((target("avx512f")))
+    void xor_array_avx512(uint64_t dst[], const uint64_t src[], size_t size)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            __m512i a = _mm512_loadu_si512(dst + i);
+            __m512i b = _mm512_loadu_si512(src + i);
+            _mm512_storeu_si512(dst + i, _mm512_xor_si512(a, b));
+        }
+        if (i < size) {
+            __mmask8 k = static_cast<__mmask8>((1u << (size - i)) - 1);
+            __m512i a = _mm512_maskz_loadu_epi64(k, dst + i);
+            __m512i b = _mm512_maskz_loadu_epi64(k, src + i);
+            _mm512_mask_storeu_epi64(dst + i, k, _mm512_xor_si512(a, b));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void convert_array_avx512(double out[], const uint64_t x[],
+                              const uint64_t shift[], size_t size)
+    {
+        const __m512i one = _mm512_set1_epi64(mantissa_one);
+        const __m512d offset = _mm512_set1_pd(mantissa_offset);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            __m512i a = _mm512_loadu_si512(x + i);
+            __m512i b = _mm512_loadu_si512(shift + i);
+            a = _mm512_maskz_srli_epi64(all_lanes, _mm512_xor_si512(a, b), 12);
+            a = _mm512_or_si512(a, one);
+            _mm512_storeu_pd(out + i,
+                             _mm512_sub_pd(_mm512_castsi512_pd(a), offset));
+        }
+        if (i < size) {
+            __mmask8 k = static_cast<__mmask8>((1u << (size - i)) - 1);
+            __m512i a = _mm512_maskz_loadu_epi64(k, x + i);
+            __m512i b = _mm512_maskz_loadu_epi64(k, shift + i);
+            a = _mm512_maskz_srli_epi64(all_lanes, _mm512_xor_si512(a, b), 12);
+            a = _mm512_or_si512(a, one);
+            _mm512_mask_storeu_pd(out + i, k,
+                                  _mm512_sub_pd(_mm512_castsi512_pd(a),
+                                                offset));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    inline __m512i swap_bits_avx512(__m512i x, uint64_t mask, int k)
+    {
+        const __m512i mk = _mm512_set1_epi64(mask);
+        __m512i hi = _mm512_maskz_srli_epi64(all_lanes, x, k);
+        __m512i lo = _mm512_maskz_slli_epi64(all_lanes,
+                                             _mm512_and_si512(x, mk), k);
+        return _mm512_or_si512(_mm512_and_si512(hi, mk), lo);
+    }
+
+    __attribute__((target("avx512f")))
+    inline __m512i reverse_bit_avx512(__m512i x)
+    {
+        x = swap_bits_avx512(x, UINT64_C(0x5555555555555555), 1);
+        x = swap_bits_avx512(x, UINT64_C(0x3333333333333333), 2);
+        x = swap_bits_avx512(x, UINT64_C(0x0f0f0f0f0f0f0f0f), 4);
+        x = swap_bits_avx512(x, UINT64_C(0x00ff00ff00ff00ff), 8);
+        x = swap_bits_avx512(x, UINT64_C(0x0000ffff0000ffff), 16);
+        return _mm512_maskz_ror_epi64(all_lanes, x, 32);
+    }
+
+    /*
+     * lower 64 bits of a * b, 64-bit multiplication needs AVX512DQ.
+     */
+    __attribute__((target("avx512f")))
+    inline __m512i mullo_avx512(__m512i a, __m512i b)
+    {
+        __m512i a32 = _mm512_maskz_srli_epi64(all_lanes, a, 32);
+        __m512i b32 = _mm512_maskz_srli_epi64(all_lanes, b, 32);
+        __m512i lo = _mm512_maskz_mul_epu32(all_lanes, a, b);
+        __m512i hi = _mm512_add_epi64(
+            _mm512_maskz_mul_epu32(all_lanes, a32, b),
+            _mm512_maskz_mul_epu32(all_lanes, a, b32));
+        return _mm512_add_epi64(lo,
+                                _mm512_maskz_slli_epi64(all_lanes, hi, 32));
+    }
+
+    __attribute__((target("avx512f")))
+    inline __m512i owen_scramble_avx512(__m512i x, __m512i seed)
+    {
+        const __m512i c1 = _mm512_set1_epi64(owen_mul1);
+        const __m512i c2 = _mm512_set1_epi64(owen_mul2);
+        const __m512i c3 = _mm512_set1_epi64(owen_mul3);
+        const __m512i one = _mm512_set1_epi64(1);
+        x = reverse_bit_avx512(x);
+        x = _mm512_xor_si512(x, mullo_avx512(x, c1));
+        x = _mm512_add_epi64(x, seed);
+        x = mullo_avx512(x, _mm512_or_si512(
+                             _mm512_maskz_srli_epi64(all_lanes, seed, 32),
+                             one));
+        x = _mm512_xor_si512(x, mullo_avx512(x, c2));
+        x = _mm512_xor_si512(x, mullo_avx512(x, c3));
+        return reverse_bit_avx512(x);
+    }
+
+    __attribute__((target("avx512f")))
+    void owen_convert_array_avx512(double out[], const uint64_t x[],
+                                   const uint64_t shift[],
+                                   const uint64_t seed[], size_t size)
+    {
+        const __m512i one = _mm512_set1_epi64(mantissa_one);
+        const __m512d offset = _mm512_set1_pd(mantissa_offset);
+        size_t i = 0;
+        for (; i < size; i += 8) {
+            __mmask8 k = 0xff;
+            if (i + 8 > size) {
+                k = static_cast<__mmask8>((1u << (size - i)) - 1);
+            }
+            __m512i a = _mm512_maskz_loadu_epi64(k, x + i);
+            __m512i b = _mm512_maskz_loadu_epi64(k, shift + i);
+            __m512i c = _mm512_maskz_loadu_epi64(k, seed + i);
+            a = owen_scramble_avx512(_mm512_xor_si512(a, b), c);
+            a = _mm512_maskz_srli_epi64(all_lanes, a, 12);
+            a = _mm512_or_si512(a, one);
+            _mm512_mask_storeu_pd(out + i, k,
+                                  _mm512_sub_pd(_mm512_castsi512_pd(a),
+                                                offset));
+        }
+    }
+#endif // HAVE_X86_SIMD
+
+    int supported_level()
+    {
+#if defined(HAVE_X86_SIMD)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SIMD_AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SIMD_AVX2;
+        }
+        return SIMD_SSE2;
+#else
+        return SIMD_NONE;
+#endif
+    }
+
+    struct kernel_table {
+        int level;
+        xor_array_t xor_array;
+        convert_array_t convert_array;
+        owen_convert_array_t owen_convert_array;
+    };
+
+    /*
+     * kernels of each level, tables[level].level == level.
+     */
+    const kernel_table kernel_tables[] = {
+        {SIMD_NONE, xor_array_generic, convert_array_generic,
+         owen_convert_array_generic},
+#if defined(HAVE_X86_SIMD)
+        {SIMD_SSE2, xor_array_sse2, convert_array_sse2,
+         owen_convert_array_generic},
+        {SIMD_AVX2, xor_array_avx2, convert_array_avx2,
+         owen_convert_array_avx2},
+        {SIMD_AVX512, xor_array_avx512, convert_array_avx512,
+         owen_convert_array_avx512}
+#endif
+    };
+
+    const kernel_table * select_kernels(int level)
+    {
+        int max_level = supported_level();
+        if (level > max_level) {
+            level = max_level;
+        }
+        if (level < SIMD_NONE) {
+            level = SIMD_NONE;
+        }
+        return &kernel_tables[level];
+    }
+
+    /*
+     * Kernels in use. Tables are immutable and only this pointer is
+     * replaced, so kernels called by other threads during
+     * setSimdLevel() are those of the old or the new level, both of
+     * which give the same results.
+     */
+    atomic<const kernel_table *> kernels(select_kernels(SIMD_AVX512));
+}
+
+namespace DigitalNetNS {
+    int getSimdLevel()
+    {
+        return kernels.load(memory_order_acquire)->level;
+    }
+
+    int setSimdLevel(int level)
+    {
+        const kernel_table * t = select_kernels(level);
+        kernels.store(t, memory_order_release);
+        return t->level;
+    }
+
+    void xorArray(uint64_t dst[], const uint64_t src[], size_t size)
+    {
+        kernels.load(memory_order_acquire)->xor_array(dst, src, size);
+    }
+
+    void convertArray(double out[], const uint64_t x[],
+                      const uint64_t shift[], size_t size)
+    {
+        kernels.load(memory_order_acquire)->convert_array(out, x, shift,
+                                                          size);
+    }
+
+    void owenConvertArray(double out[], const uint64_t x[],
+                          const uint64_t shift[], const uint64_t seed[],
+                          size_t size)
+    {
+        kernels.load(memory_order_acquire)->owen_convert_array(out, x, shift,
+                                                               seed, size);
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+#ifndef SIMD_KERNEL_H
+#define SIMD_KERNEL_H
+/**
+ * @file simd_kernel.h
+ *
+ * @brief inner loops of DigitalNet point generation.
+ *
+ * 64-bit kernels have SSE2, AVX2 and AVX-512 versions, one of them is
+ * selected at run time according to the CPU. 32-bit kernels are plain
+ * loops.
+ *
+ * Owen scrambling here is the hash based nested uniform scrambling of
+ * Laine and Karras, improved by Burley: bit reversed x is permuted by
+ * a bijection whose k-th bit depends only on lower bits, so in the
+ * original order, each bit is flipped according to the bits above it.
+ *
+ * @author Shinsuke Mori (Hiroshima University)
+ * @author Makoto Matsumoto (Hiroshima University)
+ * @author Mutsuo Saito
+ *
+ * Copyright (C) 2017 Shinsuke Mori, Makoto Matsumoto, Mutsuo Saito
+ * and Hiroshima University.
+ * All rights reserved.
+ *
+ * The GPL ver.3 is applied to this software, see
+ * COPYING
+ */
+#include "bit_operator.h"
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+
+// [[Rcpp::plugins(cpp11)]]
+
+namespace DigitalNetNS {
+
+    enum simd_level {
+        SIMD_NONE = 0,
+        SIMD_SSE2 = 1,
+        SIMD_AVX2 = 2,
+        SIMD_AVX512 = 3
+    };
+
+    /**
+     * Returns the level of kernels currently used.
+     * @return one of simd_level
+     */
+    int getSimdLevel();
+
+    /**
+     * Changes the level of kernels, mainly for test and benchmark.
+     * Levels which the CPU does not support are lowered to the best
+     * supported one.
+     * The kernels are switched atomically, so calling this while
+     * other threads generate points, e.g. by fillPoints() with
+     * threads, is safe, but those threads may use either level.
+     * All levels give the same points.
+     * @param level one of simd_level
+     * @return the level actually selected
+     */
+    int setSimdLevel(int level);
+
+    /**
+     * dst[i] ^= src[i] for 0 <= i < size.
+     */
+    void xorArray(uint64_t dst[], const uint64_t src[], size_t size);
+
+    /**
+     * out[i] = toDouble(x[i] ^ shift[i]) for 0 <= i < size.
+     */
+    void convertArray(double out[], const uint64_t x[],
+                      const uint64_t shift[], size_t size);
+
+    /**
+     * out[i] = toDouble(owenScramble(x[i] ^ shift[i], seed[i]))
+     * for 0 <= i < size.
+     */
+    void owenConvertArray(double out[], const uint64_t x[],
+                          const uint64_t shift[], const uint64_t seed[],
+                          size_t size);
+
+    /*
+     * 1 - 2^-53, subtracting this from [1, 2) gives the center of
+     * each 2^-52 interval, so the result is never 0 nor 1.
+     */
+    const uint64_t mantissa_one = UINT64_C(0x3ff0000000000000);
+    const double mantissa_offset = 1.0 - 1.0 / 9007199254740992.0;
+
+    /**
+     * Converts upper 52 bits of \b x to a double in (0, 1),
+     * by setting them to mantissa of a double in [1, 2).
+     */
+    inline double toDouble(uint64_t x) {
+        uint64_t u = (x >> 12) | mantissa_one;
+        double d;
+        std::memcpy(&d, &u, sizeof(double));
+        return d - mantissa_offset;
+    }
+
+    /**
+     * Converts \b x to a double in (0, 1), the same as
+     * x * 2^-32 + 2^-33.
+     */
+    inline double toDouble(uint32_t x) {
+        uint64_t u = (static_cast<uint64_t>(x) << 20) | mantissa_one;
+        double d;
+        std::memcpy(&d, &u, sizeof(double));
+        return d - (1.0 - 1.0 / 8589934592.0);
+    }
+
+    /*
+     * even constants of owenScramble(uint64_t, uint64_t)
+     */
+    const uint64_t owen_mul1 = UINT64_C(0xf050622baa1e480c);
+    const uint64_t owen_mul2 = UINT64_C(0x40e27f1dfa2901c0);
+    const uint64_t owen_mul3 = UINT64_C(0x5cd9f706cc79cfaa);
+
+    /**
+     * Owen scrambling of \b x.
+     * Different \b seed gives different scrambling.
+     * @param x bits of a coordinate, MSB first.
+     * @param seed random seed of the coordinate.
+     * @return scrambled \b x.
+     */
+    inline uint64_t owenScramble(uint64_t x, uint64_t seed) {
+        x = reverseBit(x);
+        x ^= x * owen_mul1;
+        x += seed;
+        x *= (seed >> 32) | 1;
+        x ^= x * owen_mul2;
+        x ^= x * owen_mul3;
+        return reverseBit(x);
+    }
+
+    /**
+     * 32-bit version of Owen scrambling, constants are Burley's.
+     */
+    inline uint32_t owenScramble(uint32_t x, uint32_t seed) {
+        x = reverseBit(x);
+        x ^= x * UINT32_C(0x3d20adea);
+        x += seed;
+        x *= (seed >> 16) | 1;
+        x ^= x * UINT32_C(0x05526c56);
+        x ^= x * UINT32_C(0x53a22864);
+        return reverseBit(x);
+    }
+
+    inline void xorArray(uint32_t dst[], const uint32_t src[], size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            dst[i] ^= src[i];
+        }
+    }
+
+    inline void convertArray(double out[], const uint32_t x[],
+                             const uint32_t shift[], size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            out[i] = toDouble(x[i] ^ shift[i]);
+        }
+    }
+
+    inline void owenConvertArray(double out[], const uint32_t x[],
+                                 const uint32_t shift[],
+                                 const uint32_t seed[], size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            out[i] = toDouble(owenScramble(x[i] ^ shift[i], seed[i]));
+        }
+    }
+}
+#endif // SIMD_KERNEL_H